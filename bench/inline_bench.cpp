@@ -0,0 +1,71 @@
+#include <lib/ArgParser.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+    Стоимость настройки парсера и чтения значений. Собирается дважды:
+    с библиотекой argparser (inline_bench) и с argparser_header_only
+    (inline_bench_header_only), где все определения доступны для встраивания
+*/
+
+using Clock = std::chrono::steady_clock;
+
+static double Nanoseconds(Clock::time_point start, size_t operations) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations;
+}
+
+int main() {
+    constexpr size_t kArguments = 64;
+    constexpr size_t kRounds = 2000;
+    constexpr size_t kLookups = 1000000;
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < kArguments; ++i) {
+        names.push_back("option-" + std::to_string(i));
+    }
+
+    auto start = Clock::now();
+    size_t checksum = 0;
+    for (size_t round = 0; round < kRounds; ++round) {
+        ArgumentParser::ArgParser parser("Inline");
+        for (size_t i = 0; i < kArguments; i += 2) {
+            parser.AddIntArgument(names[i]).Default(static_cast<int>(i));
+            parser.AddFlag(names[i + 1]);
+        }
+        checksum += parser.GetIntValue(names[round % kArguments & ~size_t{1}]);
+    }
+    double configure_time = Nanoseconds(start, kRounds * kArguments);
+
+    ArgumentParser::ArgParser parser("Inline");
+    int value = 0;
+    parser.AddIntArgument('n', "number").Default(1);
+    parser.AddIntArgument("stored").StoreValue(value).Default(2);
+    parser.AddFlag('v', "verbose");
+    parser.Parse(std::vector<std::string>{"app", "-n", "5", "--verbose"});
+
+    start = Clock::now();
+    for (size_t i = 0; i < kLookups; ++i) {
+        checksum += parser.GetIntValue("number");
+    }
+    double long_lookup_time = Nanoseconds(start, kLookups);
+
+    start = Clock::now();
+    for (size_t i = 0; i < kLookups; ++i) {
+        checksum += parser.GetIntValue('n') + parser.GetFlag('v');
+    }
+    double short_lookup_time = Nanoseconds(start, kLookups);
+
+    start = Clock::now();
+    for (size_t i = 0; i < kLookups; ++i) {
+        checksum += parser.GetValue<int>("stored");
+    }
+    double typed_lookup_time = Nanoseconds(start, kLookups);
+
+    std::cout << "configure_ns/arg\tlong_lookup_ns\tshort_lookup_ns\ttyped_lookup_ns\tchecksum\n";
+    std::cout << configure_time << "\t" << long_lookup_time << "\t" << short_lookup_time << "\t" << typed_lookup_time << "\t"
+              << checksum << "\n";
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <lib/ArgParser.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+/*
+    Замер масштабирования парсера: регистрация N аргументов,
+    разбор командной строки, где используется лишь несколько из них,
+    и построение справки. Память считается по вызовам operator new
+*/
+
+static size_t allocated_bytes = 0;
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocated_bytes += size;
+    ++allocations;
+    if (void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// Через эту перегрузку выделяет блоки арена (std::pmr)
+void* operator new(size_t size, std::align_val_t align) {
+    allocated_bytes += size;
+    ++allocations;
+    size_t alignment = static_cast<size_t>(align);
+    if (void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1))) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+using Clock = std::chrono::steady_clock;
+
+static double Microseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+static void Run(size_t count) {
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        names.push_back("option-" + std::to_string(i));
+    }
+
+    size_t bytes_before = allocated_bytes;
+    size_t allocations_before = allocations;
+    auto start = Clock::now();
+
+    ArgumentParser::ArgParser parser("Scaling");
+    parser.Reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 2 == 0) {
+            parser.AddIntArgument(names[i], "integer option").Default(0);
+        } else {
+            parser.AddFlag(names[i], "flag option");
+        }
+    }
+    parser.AddHelp('h', "help", "Scaling benchmark");
+
+    double register_time = Microseconds(start);
+    size_t register_bytes = allocated_bytes - bytes_before;
+    size_t register_allocations = allocations - allocations_before;
+
+    std::vector<std::string> args = {"app", "--option-0=1", "--option-1", "--" + names[count / 2], "7"};
+    start = Clock::now();
+    bool parsed = static_cast<bool>(parser.Parse(args));
+    double parse_time = Microseconds(start);
+
+    start = Clock::now();
+    size_t help_size = parser.HelpDescription().size();
+    double help_time = Microseconds(start);
+
+    std::cout << count << "\t" << register_time << "\t" << register_bytes / count << "\t"
+              << static_cast<double>(register_allocations) / count << "\t" << parse_time << "\t" << help_time << "\t"
+              << (parsed ? "ok" : "fail") << "\t" << help_size << "\n";
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> counts = {1000, 5000, 20000, 50000};
+    if (argc > 1) {
+        counts = {static_cast<size_t>(std::stoul(argv[1]))};
+    }
+
+    std::cout << "count\tregister_us\tbytes/arg\tallocs/arg\tparse_us\thelp_us\tparse\thelp_bytes\n";
+    for (size_t count : counts) {
+        Run(count);
+    }
+    return 0;
+}
@@ -19,10 +19,13 @@ int main(int argc, char** argv) {
     parser.AddIntArgument("N").MultiValue(1).Positional().StoreValues(values);
     parser.AddFlag('s', "sum", "add args").StoreValue(opt.sum);
     parser.AddFlag("mult", "multiply args").StoreValue(opt.mult);
+    parser.MutuallyExclusive({"sum", "mult"});
     parser.AddHelp('h', "help", "Program accumulate arguments");
 
-    if (!parser.Parse(argc, argv)) {
+    ParseResult result = parser.Parse(argc, argv);
+    if (!result) {
         std::cout << "Wrong argument" << std::endl;
+        std::cout << result.ErrorMessage() << std::endl;
         std::cout << parser.HelpDescription() << std::endl;
         return 1;
     }
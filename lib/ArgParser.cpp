@@ -1,395 +1,1071 @@
 #include "ArgParser.h"
 
+#include <algorithm>
+#include <bit>
 #include <iostream>
-using namespace ArgumentParser;
-
-template <typename T>
-ArgParser& ArgParser::AddArgument(char short_name, const std::string& long_name, const std::string& description) {
-    ArgType type;
-    if constexpr (std::is_same_v<T, int>) {
-        type = ArgType::INT;
-    } else if constexpr (std::is_same_v<T, bool>) {
-        type = ArgType::BOOL;
-    } else if constexpr (std::is_same_v<T, std::string>) {
-        type = ArgType::STRING;
-    } else {
-        throw std::invalid_argument("Unsupported type");
+#include <utility>
+
+#ifdef _WIN32
+#include <stdlib.h>
+#define environ _environ
+#else
+extern char** environ;
+#endif
+
+namespace ArgumentParser {
+
+ARGPARSER_INLINE ArgParser& ArgParser::Reserve(size_t count) {
+    reserved_count_ = count;
+    arguments_.reserve(count);
+    ordered_arguments_.reserve(count);
+    flag_slots_.reserve(count);
+    seen_.reserve((count + 63) / 64);
+    return *this;
+}
+
+ARGPARSER_INLINE std::pmr::monotonic_buffer_resource& ArgParser::Arena() {
+    if (!arena_) {
+        // Около 128 байт на аргумент вместе с именем и описанием
+        arena_ = std::make_unique<std::pmr::monotonic_buffer_resource>(std::max<size_t>(reserved_count_ * 128, 1024));
+    }
+    return *arena_;
+}
+
+ARGPARSER_INLINE std::string_view ArgParser::StoreString(std::string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+    char* data = static_cast<char*>(Arena().allocate(text.size(), 1));
+    std::copy(text.begin(), text.end(), data);
+    return std::string_view(data, text.size());
+}
+
+ARGPARSER_INLINE ArgParser& ArgParser::RegisterArgument(Argument* arg, const std::string& long_name, const std::string& description) {
+    // Настройка предыдущего аргумента закончена, лишние кандидаты убираются сразу
+    if (!required_arguments_.empty() && required_arguments_.back() == last_added_argument_ &&
+        !IsRequiredCandidate(last_added_argument_)) {
+        required_arguments_.pop_back();
     }
 
-    TypedArgument<T>* arg = new TypedArgument<T>(type);
-    arg->SetLongName(long_name);
-    arg->SetShortName(short_name);
-    arg->SetDescription(description);
+    std::string_view name = StoreString(long_name);
+    arg->SetIndex(ordered_arguments_.size());
+    arg->SetLongName(name);
+    arg->SetDescription(StoreString(description));
 
-    arguments_[long_name] = arg;
-    short_name_map_[short_name] = arg;
+    arguments_[name] = arg;
+    ordered_arguments_.push_back(arg);
+    flag_slots_.push_back(kNotFlag);
+    required_arguments_.push_back(arg);
+    seen_.resize((ordered_arguments_.size() + 63) / 64);
 
     last_added_argument_ = arg;
+    return *this;
+}
 
+ARGPARSER_INLINE ArgParser& ArgParser::RegisterShortName(char short_name) {
+    last_added_argument_->SetShortName(short_name);
+    short_names_[static_cast<unsigned char>(short_name)] = last_added_argument_;
     return *this;
 }
 
-template <typename T>
-ArgParser& ArgParser::AddArgument(const std::string& long_name, const std::string& description) {
-    ArgType type;
-    if constexpr (std::is_same_v<T, int>) {
-        type = ArgType::INT;
-    } else if constexpr (std::is_same_v<T, bool>) {
-        type = ArgType::BOOL;
-    } else if constexpr (std::is_same_v<T, std::string>) {
-        type = ArgType::STRING;
-    } else {
-        throw std::invalid_argument("Unsupported type");
+ARGPARSER_INLINE bool ArgParser::IsRequiredCandidate(const Argument* argument) const {
+    if (argument->IsMultiValue() && argument->GetMinMultiValues() > 0) {
+        return true;
     }
+    return !argument->IsInitialized() && argument->GetType() != ArgType::BOOL && argument != help_argument_;
+}
 
-    TypedArgument<T>* arg = new TypedArgument<T>(type);
-
-    arg->SetLongName(long_name);
-    arg->SetDescription(description);
-
-    arguments_[long_name] = arg;
-
-    last_added_argument_ = arg;
-    return *this;
+ARGPARSER_INLINE void ArgParser::CompactRequired() {
+    std::erase_if(required_arguments_, [this](const Argument* argument) { return !IsRequiredCandidate(argument); });
 }
 
-ArgParser& ArgParser::AddStringArgument(char short_name, const std::string& long_name, const std::string& description) {
+ARGPARSER_INLINE ArgParser& ArgParser::AddStringArgument(char short_name, const std::string& long_name, const std::string& description) {
     return AddArgument<std::string>(short_name, long_name, description);
 }
 
-ArgParser& ArgParser::AddStringArgument(const std::string& long_name, const std::string& description) {
+ARGPARSER_INLINE ArgParser& ArgParser::AddStringArgument(const std::string& long_name, const std::string& description) {
     return AddArgument<std::string>(long_name, description);
 }
 
-ArgParser& ArgParser::AddIntArgument(char short_name, const std::string& long_name, const std::string& description) {
+ARGPARSER_INLINE ArgParser& ArgParser::AddIntArgument(char short_name, const std::string& long_name, const std::string& description) {
     return AddArgument<int>(short_name, long_name, description);
 }
 
-ArgParser& ArgParser::AddIntArgument(const std::string& long_name, const std::string& description) {
+ARGPARSER_INLINE ArgParser& ArgParser::AddIntArgument(const std::string& long_name, const std::string& description) {
     return AddArgument<int>(long_name, description);
 }
 
-ArgParser& ArgParser::AddFlag(char short_name, const std::string& long_name, const std::string& description) {
-    return AddArgument<bool>(short_name, long_name, description);
+ARGPARSER_INLINE ArgParser& ArgParser::AddFlag(char short_name, const std::string& long_name, const std::string& description) {
+    AddFlag(long_name, description);
+    return RegisterShortName(short_name);
 }
 
-ArgParser& ArgParser::AddFlag(const std::string& long_name, const std::string& description) {
-    return AddArgument<bool>(long_name, description);
+ARGPARSER_INLINE ArgParser& ArgParser::AddFlag(const std::string& long_name, const std::string& description) {
+    AddArgument<bool>(long_name, description);
+    flag_slots_.back() = static_cast<uint32_t>(flag_count_++);
+    flag_arguments_.push_back(static_cast<TypedArgument<bool>*>(last_added_argument_));
+    flags_.resize((flag_count_ + 63) / 64);
+    flag_defaults_.resize(flags_.size());
+    flag_stores_.resize(flags_.size());
+    return *this;
 }
 
-ArgParser& ArgParser::Default(const char* value) {
-    std::string new_value = std::string(value);
-    return MakeDefault(new_value);
+ARGPARSER_INLINE ArgParser& ArgParser::AddCountFlag(char short_name, const std::string& long_name, const std::string& description) {
+    AddCountFlag(long_name, description);
+    return RegisterShortName(short_name);
 }
 
-ArgParser& ArgParser::Default(int value) {
-    return MakeDefault(value);
+ARGPARSER_INLINE ArgParser& ArgParser::AddCountFlag(const std::string& long_name, const std::string& description) {
+    auto* counter = NewArgument<CountArgument>();
+    RegisterArgument(counter, long_name, description);
+    flag_slots_.back() = kCountFlag;
+    counters_.push_back(counter);
+    return *this;
 }
 
-ArgParser& ArgParser::Default(bool value) {
-    return MakeDefault(value);
+ARGPARSER_INLINE const std::vector<uint64_t>& ArgParser::GetFlags() const {
+    return flags_;
 }
 
-template <typename T>
-ArgParser& ArgParser::MakeDefault(T& value) {
-    if (!last_added_argument_) {
-        throw std::runtime_error("No argument added to configure.");
+ARGPARSER_INLINE size_t ArgParser::FlagBit(const std::string& long_name) const {
+    auto it = arguments_.find(long_name);
+    if (it == arguments_.end()) {
+        throw std::invalid_argument("Argument not found");
     }
-
-    auto* typed_arg = dynamic_cast<TypedArgument<T>*>(last_added_argument_);
-    if (typed_arg) {
-        typed_arg->SetDefault(value);
-        return *this;
+    uint32_t slot = flag_slots_[it->second->GetIndex()];
+    if (slot >= kCountFlag) {
+        throw std::invalid_argument("Argument is not a plain flag: " + long_name);
     }
+    return slot;
+}
 
-    throw std::invalid_argument("Argument does not support default values of this type.");
+ARGPARSER_INLINE ArgParser& ArgParser::Default(const char* value) {
+    std::string new_value = std::string(value);
+    return MakeDefault(new_value);
 }
 
-ArgParser& ArgParser::MultiValue(int min_values) {
-    if (!last_added_argument_) {
-        throw std::runtime_error("No argument added to configure.");
-    }
+ARGPARSER_INLINE ArgParser& ArgParser::Default(int value) {
+    return MakeDefault(value);
+}
 
-    last_added_argument_->SetMultiValue(min_values);
+ARGPARSER_INLINE ArgParser& ArgParser::Default(bool value) {
+    MakeDefault(value);
+    uint32_t slot = flag_slots_[last_added_argument_->GetIndex()];
+    if (slot < kCountFlag) {
+        AssignFlagBit(flag_defaults_, slot, value);
+        AssignFlagBit(flags_, slot, value);
+    }
     return *this;
 }
 
-template <typename T>
-ArgParser& ArgParser::MakeStoreValues(std::vector<T>& values) {
+ARGPARSER_INLINE ArgParser& ArgParser::MultiValue(int min_values) {
     if (!last_added_argument_) {
         throw std::runtime_error("No argument added to configure.");
     }
 
-    auto* typed_arg = dynamic_cast<TypedArgument<T>*>(last_added_argument_);
-    if (!typed_arg) {
-        throw std::invalid_argument("Argument does not support storing values of this type.");
+    last_added_argument_->SetMultiValue(min_values);
+    // Каждое появление флага MultiValue сохраняется отдельно, в битовый набор он не попадает
+    if (flag_slots_[last_added_argument_->GetIndex()] != kCountFlag) {
+        flag_slots_[last_added_argument_->GetIndex()] = kNotFlag;
+    }
+    if (min_values > 0 && (required_arguments_.empty() || required_arguments_.back() != last_added_argument_)) {
+        required_arguments_.push_back(last_added_argument_);
     }
-
-    typed_arg->StoreValues(values);
     return *this;
 }
 
-ArgParser& ArgParser::StoreValues(std::vector<int>& values) {
+ARGPARSER_INLINE ArgParser& ArgParser::StoreValues(std::vector<int>& values) {
     return MakeStoreValues(values);
 }
 
-ArgParser& ArgParser::StoreValues(std::vector<std::string>& values) {
+ARGPARSER_INLINE ArgParser& ArgParser::StoreValues(std::vector<std::string>& values) {
     return MakeStoreValues(values);
 }
 
-ArgParser& ArgParser::StoreValues(std::vector<bool>& values) {
+ARGPARSER_INLINE ArgParser& ArgParser::StoreValues(std::vector<bool>& values) {
     return MakeStoreValues(values);
 }
 
-template <typename T>
-ArgParser& ArgParser::MakeStoreValue(T& value) {
+ARGPARSER_INLINE ArgParser& ArgParser::StoreValues(StringPool& values) {
     if (!last_added_argument_) {
         throw std::runtime_error("No argument added to configure.");
     }
 
-    auto* typed_arg = dynamic_cast<TypedArgument<T>*>(last_added_argument_);
+    auto* typed_arg = dynamic_cast<TypedArgument<std::string>*>(last_added_argument_);
     if (!typed_arg) {
-        throw std::invalid_argument("Argument does not support storing value of this type.");
+        throw std::invalid_argument("Argument does not support storing values of this type.");
     }
 
-    typed_arg->StoreValue(value);
+    typed_arg->StoreValues(values);
     return *this;
 }
 
-ArgParser& ArgParser::StoreValue(std::string& value) {
+ARGPARSER_INLINE ArgParser& ArgParser::StoreValue(std::string& value) {
     return MakeStoreValue(value);
 }
 
-ArgParser& ArgParser::StoreValue(bool& value) {
-    return MakeStoreValue(value);
+ARGPARSER_INLINE ArgParser& ArgParser::StoreValue(bool& value) {
+    MakeStoreValue(value);
+    uint32_t slot = flag_slots_[last_added_argument_->GetIndex()];
+    if (slot < kCountFlag) {
+        AssignFlagBit(flag_stores_, slot, true);
+    }
+    return *this;
 }
 
-ArgParser& ArgParser::StoreValue(int& value) {
+ARGPARSER_INLINE ArgParser& ArgParser::StoreValue(int& value) {
     return MakeStoreValue(value);
 }
 
-ArgParser& ArgParser::Positional(bool value) {
+ARGPARSER_INLINE ArgParser& ArgParser::Lazy(bool value) {
     if (!last_added_argument_) {
         throw std::runtime_error("No argument added to configure.");
     }
 
-    last_added_argument_->SetPositional(value);
+    last_added_argument_->SetLazy(value);
+    if (value) {
+        lazy_arguments_.push_back(last_added_argument_);
+    }
     return *this;
 }
 
-template <typename T>
-T ArgParser::GetValue(const std::string& long_name) {
-    if (arguments_.find(long_name) == arguments_.end())
-        throw std::invalid_argument("Argument not found");
-
-    Argument* arg = arguments_[long_name];
-    TypedArgument<T>* typedArg = dynamic_cast<TypedArgument<T>*>(arg);
-    if (!typedArg) {
-        throw std::bad_cast();
+ARGPARSER_INLINE ArgParser& ArgParser::NonEmpty(bool value) {
+    if (!last_added_argument_) {
+        throw std::runtime_error("No argument added to configure.");
     }
-    return typedArg->GetValue();
+
+    last_added_argument_->SetNonEmpty(value);
+    return *this;
 }
 
-template <typename T>
-T ArgParser::GetValue(const char& short_name) {
-    if (short_name_map_.find(short_name) == short_name_map_.end())
-        throw std::invalid_argument("Argument not found");
+ARGPARSER_INLINE ArgParser& ArgParser::Positional(bool value) {
+    if (!last_added_argument_) {
+        throw std::runtime_error("No argument added to configure.");
+    }
 
-    Argument* arg = short_name_map_[short_name];
-    TypedArgument<T>* typedArg = dynamic_cast<TypedArgument<T>*>(arg);
-    if (!typedArg)
-        throw std::bad_cast();
-    return typedArg->GetValue();
+    last_added_argument_->SetPositional(value);
+    std::erase(positional_arguments_, last_added_argument_);
+    if (value) {
+        positional_arguments_.push_back(last_added_argument_);
+    }
+    return *this;
 }
 
-int ArgParser::GetIntValue(const std::string& argument, const int& multi_value) {
+ARGPARSER_INLINE int ArgParser::GetIntValue(const std::string& argument, const int& multi_value) {
     return GetValue<int>(argument);
 }
 
-int ArgParser::GetIntValue(const char& argument, const int& multi_value) {
+ARGPARSER_INLINE int ArgParser::GetIntValue(const char& argument, const int& multi_value) {
     return GetValue<int>(argument);
 }
 
-std::string ArgParser::GetStringValue(const std::string& argument, const int& multi_value) {
+ARGPARSER_INLINE std::string ArgParser::GetStringValue(const std::string& argument, const int& multi_value) {
     return GetValue<std::string>(argument);
 }
 
-std::string ArgParser::GetStringValue(const char& argument, const int& multi_value) {
+ARGPARSER_INLINE std::string ArgParser::GetStringValue(const char& argument, const int& multi_value) {
     return GetValue<std::string>(argument);
 }
 
-bool ArgParser::GetFlag(const std::string& argument, const int& multi_value) {
+ARGPARSER_INLINE bool ArgParser::GetFlag(const std::string& argument, const int& multi_value) {
     return GetValue<bool>(argument);
 }
 
-bool ArgParser::GetFlag(const char& argument, const int& multi_value) {
+ARGPARSER_INLINE bool ArgParser::GetFlag(const char& argument, const int& multi_value) {
     return GetValue<bool>(argument);
 }
 
-int ArgParser::Parse(const std::vector<std::string>& parse_values) {
+ARGPARSER_INLINE ParseResult ArgParser::Parse(const std::vector<std::string>& parse_values) {
+    // Ленивые значения, остаток и опции плагинов ссылаются на токены после
+    // возврата из Parse, только тогда нужна собственная копия
+    const std::vector<std::string>* tokens = &parse_values;
+    if (!lazy_arguments_.empty() || allow_unknown_ || !plugins_.empty()) {
+        owned_args_ = parse_values;
+        tokens = &owned_args_;
+    } else {
+        owned_args_.clear();
+    }
+
     std::vector<const char*> argv;
-    for (const auto& value : parse_values)
+    argv.reserve(tokens->size());
+    for (const auto& value : *tokens)
         argv.push_back(value.c_str());
 
     return Parse(static_cast<int>(argv.size()), const_cast<char**>(argv.data()));
 }
 
-bool ArgParser::ParseLongArgument(std::string arg, Argument*& current_argument) {
+ARGPARSER_INLINE bool ArgParser::ParseLongArgument(std::string_view arg, Argument*& current_argument) {
     size_t equal_pos = arg.find('=');
-    std::string long_name = arg.substr(2, equal_pos - 2);
+    std::string_view long_name = arg.substr(2, equal_pos - 2);
+    std::optional<std::string_view> value;
+    if (equal_pos != std::string_view::npos) {
+        value = arg.substr(equal_pos + 1);
+    }
+
+    // --plugin.name.option[=value] передается парсеру плагина name
+    if (!plugins_.empty() && long_name.starts_with(kPluginPrefix)) {
+        std::string_view rest = long_name.substr(kPluginPrefix.size());
+        size_t dot_pos = rest.find('.');
+        if (dot_pos != std::string_view::npos) {
+            current_argument = nullptr;
+            return ParsePluginArgument(arg, rest.substr(0, dot_pos), rest.substr(dot_pos + 1), value);
+        }
+    }
+    return ParseLongOption(arg, long_name, value, current_argument);
+}
+
+ARGPARSER_INLINE bool ArgParser::ParseLongOption(std::string_view arg, std::string_view long_name, std::optional<std::string_view> value,
+                                                 Argument*& current_argument) {
     if (CheckHelp(long_name)) {
         return true;
     }
-    if (arguments_.find(long_name) != arguments_.end()) {
-        current_argument = arguments_[long_name];
-        if (equal_pos != std::string::npos) {
-            std::string value = arg.substr(equal_pos + 1);
-            current_argument->ParseValue(value);
+    auto it = arguments_.find(long_name);
+    if (it != arguments_.end()) {
+        current_argument = it->second;
+        if (value) {
+            ApplyValue(current_argument, *value);
             current_argument = nullptr;
         } else if (current_argument->GetType() == ArgType::BOOL) {
-            dynamic_cast<TypedArgument<bool>*>(current_argument)->AddValue(true);
+            ApplyFlag(current_argument);
+            current_argument = nullptr;
         }
+    } else if (allow_unknown_) {
+        AddToRemainder(arg);
+        current_argument = nullptr;
     } else {
-        throw std::runtime_error("Unknown argument: " + long_name);
+        throw std::runtime_error("Unknown argument: " + option_prefix_ + std::string(long_name) +
+                                 SuggestionMessage(SuggestArgument(long_name)));
     }
     return false;
 }
 
-int ArgParser::Parse(int argc, char** argv) {
-    std::string_view current_arg;
-    Argument* current_argument = nullptr;
+ARGPARSER_INLINE bool ArgParser::ParsePluginArgument(std::string_view arg, std::string_view plugin_name, std::string_view option,
+                                                     std::optional<std::string_view> value) {
+    auto it = plugins_.find(plugin_name);
+    if (it == plugins_.end()) {
+        if (allow_unknown_) {
+            AddToRemainder(arg);
+            return false;
+        }
+        throw std::runtime_error("Unknown plugin: " + std::string(plugin_name));
+    }
+
+    Plugin& plugin = it->second;
+    ArgParser& child = LoadPlugin(it->first, plugin);
+    if (!child.parsing_) {
+        child.BeginParse();
+        active_plugins_.push_back(&child);
+    }
 
-    std::vector<Argument*> positional_args;
+    child.copy_tokens_ = copy_tokens_;
+    bool help = child.ParseLongOption(arg, option, value, child.current_argument_);
+    // Значение может прийти следующим токеном
+    if (child.current_argument_) {
+        current_plugin_ = &child;
+    }
+    return help;
+}
 
-    for (auto& [name, argument] : arguments_) {
-        if (argument->IsPositional()) {
-            positional_args.push_back(argument);
+ARGPARSER_INLINE ArgParser& ArgParser::LoadPlugin(std::string_view name, Plugin& plugin) {
+    if (!plugin.parser) {
+        plugin.parser = std::make_unique<ArgParser>(std::string(kPluginPrefix) + std::string(name));
+        plugin.parser->option_prefix_ = std::string(kPluginPrefix) + std::string(name) + ".";
+        plugin.factory(*plugin.parser);
+    }
+    return *plugin.parser;
+}
+
+ARGPARSER_INLINE ArgParser& ArgParser::AddPlugin(const std::string& name, PluginFactory factory, const std::string& description) {
+    if (name.empty() || name.find('.') != std::string::npos) {
+        throw std::invalid_argument("Invalid plugin name: " + name);
+    }
+    auto [it, inserted] = plugins_.insert_or_assign(name, Plugin{std::move(factory), description, nullptr});
+    if (inserted) {
+        plugin_names_.push_back(name);
+    }
+    return *this;
+}
+
+ARGPARSER_INLINE ArgParser& ArgParser::GetPlugin(const std::string& name) {
+    auto it = plugins_.find(name);
+    if (it == plugins_.end()) {
+        throw std::invalid_argument("Plugin not found");
+    }
+    return LoadPlugin(it->first, it->second);
+}
+
+ARGPARSER_INLINE bool ArgParser::IsPluginLoaded(const std::string& name) const {
+    auto it = plugins_.find(name);
+    return it != plugins_.end() && it->second.parser;
+}
+
+ARGPARSER_INLINE ParseResult ArgParser::Parse(int argc, char** argv) {
+    BeginParse();
+    // argv живет дольше разбора, ленивые значения могут ссылаться на него
+    copy_tokens_ = false;
+    for (int i = 1; i < argc; ++i) {
+        FeedToken(argv[i]);
+    }
+    return Finish();
+}
+
+ARGPARSER_INLINE void ArgParser::BeginParse() {
+    parsing_ = true;
+    help_requested_ = false;
+    awaiting_value_ = false;
+    current_argument_ = nullptr;
+
+    positional_index_ = 0;
+
+    remainder_.clear();
+    passthrough_ = false;
+    current_plugin_ = nullptr;
+    // Прошлый разбор мог прерваться исключением посреди опций плагина
+    for (ArgParser* plugin : active_plugins_) {
+        plugin->parsing_ = false;
+    }
+    active_plugins_.clear();
+
+    DiscardPending();
+    fed_tokens_.clear();
+    for (const auto* arguments : {&seen_arguments_, &lazy_arguments_}) {
+        for (Argument* argument : *arguments) {
+            argument->ClearViolations();
         }
     }
 
-    size_t positional_index = 0;
+    ResetFlags();
+    for (Argument* argument : seen_arguments_) {
+        seen_[argument->GetIndex() / 64] = 0;
+    }
+    seen_arguments_.clear();
+    for (CountArgument* counter : counters_) {
+        counter->Reset();
+    }
+}
 
-    for (size_t i = 1; i < argc; ++i) {
-        std::string arg = argv[i];
+// Непреобразованные токены прошлого разбора больше не нужны,
+// а их строки могли быть уже освобождены
+ARGPARSER_INLINE void ArgParser::DiscardPending() {
+    for (Argument* argument : lazy_arguments_) {
+        argument->DiscardPending();
+    }
+    for (auto& [name, plugin] : plugins_) {
+        if (plugin.parser) {
+            plugin.parser->DiscardPending();
+        }
+    }
+}
+
+ARGPARSER_INLINE void ArgParser::MarkSeen(Argument* argument) {
+    size_t index = argument->GetIndex();
+    uint64_t bit = uint64_t{1} << (index % 64);
+    if (!(seen_[index / 64] & bit)) {
+        seen_[index / 64] |= bit;
+        seen_arguments_.push_back(argument);
+    }
+}
+
+ARGPARSER_INLINE bool ArgParser::IsSeen(const Argument* argument) const {
+    size_t index = argument->GetIndex();
+    return seen_[index / 64] & (uint64_t{1} << (index % 64));
+}
 
-        // Проверка на длинный аргумент
-        if (arg.rfind("--", 0) == 0) {
-            if (ParseLongArgument(arg, current_argument)) {
-                return true;
+// Токены из Feed копируются: буфер вызывающего может быть уже освобожден
+ARGPARSER_INLINE void ArgParser::AddToRemainder(std::string_view arg) {
+    remainder_.push_back(copy_tokens_ ? std::string_view(fed_tokens_.emplace_back(arg)) : arg);
+}
+
+ARGPARSER_INLINE void ArgParser::ApplyValue(Argument* argument, std::string_view value) {
+    if (copy_tokens_ && argument->IsLazy()) {
+        value = fed_tokens_.emplace_back(value);
+    }
+    MarkSeen(argument);
+    argument->ParseValue(value);
+    // Явное значение флага (--flag=false или из окружения) переносится в бит
+    uint32_t slot = flag_slots_[argument->GetIndex()];
+    if (slot < kCountFlag) {
+        AssignFlagBit(flags_, slot, static_cast<TypedArgument<bool>*>(argument)->GetValue());
+    }
+}
+
+ARGPARSER_INLINE void ArgParser::ApplyFlag(Argument* argument) {
+    MarkSeen(argument);
+    uint32_t slot = flag_slots_[argument->GetIndex()];
+    if (slot == kCountFlag) {
+        static_cast<CountArgument*>(argument)->Increment();
+    } else if (slot < kCountFlag) {
+        SetFlagBits(slot / 64, uint64_t{1} << (slot % 64));
+    } else {
+        dynamic_cast<TypedArgument<bool>*>(argument)->AddValue(true);
+    }
+}
+
+// Аргумент флага хранит значение только для StoreValue: переменная получает
+// true сразу, как только бит включается, поэтому видит флаг уже после Feed
+ARGPARSER_INLINE void ArgParser::SetFlagBits(size_t word, uint64_t mask) {
+    uint64_t stored = mask & flag_stores_[word] & ~flags_[word];
+    flags_[word] |= mask;
+    for (; stored; stored &= stored - 1) {
+        flag_arguments_[word * 64 + std::countr_zero(stored)]->SetValue(true);
+    }
+}
+
+// Значение обычного флага берется из битового набора
+ARGPARSER_INLINE bool ArgParser::ReadFlag(TypedArgument<bool>& argument) {
+    uint32_t slot = flag_slots_[argument.GetIndex()];
+    if (slot < kCountFlag) {
+        return flags_[slot / 64] >> (slot % 64) & 1;
+    }
+    return argument.GetValue();
+}
+
+ARGPARSER_INLINE void ArgParser::AssignFlagBit(std::vector<uint64_t>& bits, uint32_t slot, bool value) {
+    uint64_t bit = uint64_t{1} << (slot % 64);
+    bits[slot / 64] = value ? bits[slot / 64] | bit : bits[slot / 64] & ~bit;
+}
+
+// Флаги, измененные в прошлом разборе, возвращаются к значениям по умолчанию
+// вместе с битовым набором
+ARGPARSER_INLINE void ArgParser::ResetFlags() {
+    for (Argument* argument : seen_arguments_) {
+        uint32_t slot = flag_slots_[argument->GetIndex()];
+        if (slot < kCountFlag) {
+            static_cast<TypedArgument<bool>*>(argument)->SetValue(flag_defaults_[slot / 64] >> (slot % 64) & 1);
+        }
+    }
+    flags_ = flag_defaults_;
+}
+
+// Буфер вызывающего может быть освобожден сразу после Feed,
+// поэтому токены ленивых аргументов копируются
+ARGPARSER_INLINE void ArgParser::Feed(std::string_view arg) {
+    copy_tokens_ = true;
+    FeedToken(arg);
+}
+
+ARGPARSER_INLINE void ArgParser::FeedToken(std::string_view arg) {
+    if (!parsing_) {
+        BeginParse();
+    }
+    if (help_requested_) {
+        return;
+    }
+    if (passthrough_) {
+        AddToRemainder(arg);
+        return;
+    }
+
+    // Опция плагина из прошлого токена ждет значение
+    ArgParser* plugin = std::exchange(current_plugin_, nullptr);
+
+    // Короткая опция из прошлого токена ждет значение
+    if (awaiting_value_) {
+        Argument* argument = std::exchange(current_argument_, nullptr);
+        awaiting_value_ = false;
+        ApplyValue(argument, arg);
+    }
+    // Все после "--" передается дальше без разбора
+    else if (allow_unknown_ && arg == "--") {
+        passthrough_ = true;
+        current_argument_ = nullptr;
+    }
+    // Проверка на длинный аргумент
+    else if (arg.starts_with("--")) {
+        help_requested_ = ParseLongArgument(arg, current_argument_);
+    }
+    // Проверка на короткий аргумент или цепочку коротких флагов
+    else if (arg.starts_with("-") && arg.size() > 1) {
+        help_requested_ = ParseShortArguments(arg);
+    } else if (plugin) {
+        plugin->copy_tokens_ = copy_tokens_;
+        plugin->FeedToken(arg);
+    } else if (current_argument_) {
+        ApplyValue(std::exchange(current_argument_, nullptr), arg);
+    }
+    // Обработка позиционных аргументов
+    else if (positional_index_ < positional_arguments_.size()) {
+        Argument* positional_arg = positional_arguments_[positional_index_];
+        ApplyValue(positional_arg, arg);
+        if (!positional_arg->IsMultiValue()) {
+            positional_index_++;
+        }
+    } else if (allow_unknown_) {
+        AddToRemainder(arg);
+    }
+}
+
+ARGPARSER_INLINE ParseResult ArgParser::Finish() {
+    parsing_ = false;
+    awaiting_value_ = false;
+    current_argument_ = nullptr;
+
+    ParseResult result;
+    if (help_requested_) {
+        for (ArgParser* plugin : active_plugins_) {
+            plugin->parsing_ = false;
+        }
+        return result;
+    }
+    ResolveEnvironment();
+    CheckMultiValueValid(&result);
+    CheckValuesValid(&result);
+    CheckConstraints(&result);
+    CheckRules(&result);
+    // Проверяются только плагины, упомянутые в этом разборе
+    for (ArgParser* plugin : active_plugins_) {
+        ParseResult plugin_result = plugin->Finish();
+        for (const ParseError& error : plugin_result.GetErrors()) {
+            result.AddError(error.argument, error.message);
+        }
+    }
+    return result;
+}
+
+ARGPARSER_INLINE bool ArgParser::ParseShortArguments(std::string_view arg) {
+    if (CheckHelp(arg)) {
+        return true;
+    }
+    current_argument_ = nullptr;
+    // Цепочка с неизвестной опцией целиком уходит в остаток
+    if (allow_unknown_ && !IsKnownShortCluster(arg)) {
+        AddToRemainder(arg);
+        return false;
+    }
+    // Биты обычных флагов цепочки собираются в маску и записываются одним OR
+    size_t mask_word = 0;
+    uint64_t mask = 0;
+    for (size_t j = 1; j < arg.size(); ++j) {
+        char short_name = arg[j];
+        Argument* argument = short_names_[static_cast<unsigned char>(short_name)];
+        if (!argument) {
+            throw std::runtime_error("Unknown argument: -" + std::string(1, short_name) +
+                                     SuggestionMessage(SuggestShortArgument(arg, short_name)));
+        }
+
+        uint32_t slot = flag_slots_[argument->GetIndex()];
+        if (slot < kCountFlag && argument->GetType() == ArgType::BOOL) {
+            if (mask && slot / 64 != mask_word) {
+                SetFlagBits(mask_word, std::exchange(mask, 0));
+            }
+            mask_word = slot / 64;
+            mask |= uint64_t{1} << (slot % 64);
+            MarkSeen(argument);
+        } else if (argument->GetType() != ArgType::BOOL) {
+            if (j == arg.size() - 1) {
+                current_argument_ = argument;
+                awaiting_value_ = true;
+            } else if (arg[j + 1] == '=') {
+                ApplyValue(argument, arg.substr(j + 2));
+                break;
+            }
+        } else {
+            ApplyFlag(argument);
+        }
+    }
+    if (mask) {
+        SetFlagBits(mask_word, mask);
+    }
+    return false;
+}
+
+ARGPARSER_INLINE bool ArgParser::IsKnownShortCluster(std::string_view arg) const {
+    for (size_t j = 1; j < arg.size(); ++j) {
+        Argument* argument = short_names_[static_cast<unsigned char>(arg[j])];
+        if (!argument) {
+            return false;
+        }
+        if (argument->GetType() != ArgType::BOOL && (j == arg.size() - 1 || arg[j + 1] == '=')) {
+            break;
+        }
+    }
+    return true;
+}
+
+// Ближайшее по расстоянию Левенштейна длинное имя или пустая строка.
+// Таблица имен строится только при первой ошибке, успешный разбор ее не трогает
+ARGPARSER_INLINE std::string ArgParser::SuggestArgument(std::string_view name) {
+    if (suggestion_names_.size() != arguments_.size()) {
+        suggestion_names_.clear();
+        suggestion_names_.reserve(arguments_.size());
+        for (const auto& [long_name, argument] : arguments_) {
+            suggestion_names_.push_back(long_name);
+        }
+    }
+
+    size_t max_distance = std::max<size_t>(1, name.size() / 3);
+    size_t best_distance = max_distance + 1;
+    std::string_view best;
+    EditDistance distance(name);
+    for (std::string_view candidate : suggestion_names_) {
+        size_t length_diff = candidate.size() > name.size() ? candidate.size() - name.size() : name.size() - candidate.size();
+        if (length_diff >= best_distance) {
+            continue;
+        }
+        size_t current = distance.Distance(candidate);
+        if (current < best_distance) {
+            best_distance = current;
+            best = candidate;
+        }
+    }
+    return best.empty() ? "" : "--" + option_prefix_ + std::string(best);
+}
+
+ARGPARSER_INLINE std::string ArgParser::SuggestShortArgument(std::string_view arg, char short_name) {
+    // "-verbose" вместо "--verbose"
+    std::string_view name = arg.substr(1, arg.find('=') - 1);
+    if (name.size() > 1) {
+        std::string suggestion = SuggestArgument(name);
+        if (!suggestion.empty()) {
+            return suggestion;
+        }
+    }
+
+    char other_case = short_name;
+    if (short_name >= 'a' && short_name <= 'z') {
+        other_case = short_name - 'a' + 'A';
+    } else if (short_name >= 'A' && short_name <= 'Z') {
+        other_case = short_name - 'A' + 'a';
+    }
+    if (other_case != short_name && short_names_[static_cast<unsigned char>(other_case)]) {
+        return "-" + std::string(1, other_case);
+    }
+    return "";
+}
+
+ARGPARSER_INLINE std::string ArgParser::SuggestionMessage(const std::string& suggestion) {
+    return suggestion.empty() ? "" : ". Did you mean " + suggestion + "?";
+}
+
+ARGPARSER_INLINE ArgParser& ArgParser::AllowUnknownArguments(bool value) {
+    allow_unknown_ = value;
+    return *this;
+}
+
+ARGPARSER_INLINE const std::vector<std::string_view>& ArgParser::GetRemainder() const {
+    return remainder_;
+}
+
+ARGPARSER_INLINE ArgParser& ArgParser::Env(const std::string& name) {
+    if (!last_added_argument_) {
+        throw std::runtime_error("No argument added to configure.");
+    }
+
+    std::string env_name = name;
+    if (env_name.empty()) {
+        for (char c : last_added_argument_->GetLongName()) {
+            if (c >= 'a' && c <= 'z') {
+                env_name += static_cast<char>(c - 'a' + 'A');
+            } else if (c == '-' || c == '.') {
+                env_name += '_';
+            } else {
+                env_name += c;
+            }
+        }
+    }
+    env_index_[env_name] = last_added_argument_;
+    return *this;
+}
+
+ARGPARSER_INLINE ArgParser& ArgParser::EnvPrefix(const std::string& prefix) {
+    env_prefix_ = prefix;
+    return *this;
+}
+
+// Один проход по environ: каждая переменная с нужным префиксом ищется
+// в индексе имен, значения из командной строки не перезаписываются
+ARGPARSER_INLINE void ArgParser::ResolveEnvironment() {
+    if (env_index_.empty() || !environ) {
+        return;
+    }
+
+    for (char** env = environ; *env; ++env) {
+        std::string_view entry = *env;
+        if (!entry.starts_with(env_prefix_)) {
+            continue;
+        }
+        size_t equal_pos = entry.find('=');
+        if (equal_pos == std::string_view::npos) {
+            continue;
+        }
+
+        auto it = env_index_.find(entry.substr(env_prefix_.size(), equal_pos - env_prefix_.size()));
+        if (it == env_index_.end() || IsSeen(it->second)) {
+            continue;
+        }
+
+        Argument* argument = it->second;
+        if (argument->IsMultiValue() && argument->HasDefaultValue()) {
+            argument->ClearValues();
+        }
+        ApplyValue(argument, entry.substr(equal_pos + 1));
+    }
+}
+
+ARGPARSER_INLINE ArgParser::ArgumentMask ArgParser::MakeMask(const std::vector<std::string>& names) {
+    if (names.empty()) {
+        throw std::invalid_argument("Rule requires at least one argument.");
+    }
+
+    std::vector<size_t> indices;
+    for (const auto& name : names) {
+        auto it = arguments_.find(name);
+        if (it == arguments_.end()) {
+            throw std::invalid_argument("Argument not found: " + name);
+        }
+        indices.push_back(it->second->GetIndex());
+    }
+
+    auto [min_index, max_index] = std::minmax_element(indices.begin(), indices.end());
+    ArgumentMask mask;
+    mask.first_word = *min_index / 64;
+    mask.bits.assign(*max_index / 64 - mask.first_word + 1, 0);
+    for (size_t index : indices) {
+        mask.bits[index / 64 - mask.first_word] |= uint64_t{1} << (index % 64);
+    }
+    for (uint64_t bits : mask.bits) {
+        mask.size += std::popcount(bits);
+    }
+    return mask;
+}
+
+ARGPARSER_INLINE ArgParser& ArgParser::MutuallyExclusive(const std::vector<std::string>& names) {
+    rules_.push_back({RuleType::MUTUALLY_EXCLUSIVE, {}, MakeMask(names)});
+    return *this;
+}
+
+ARGPARSER_INLINE ArgParser& ArgParser::RequireOneOf(const std::vector<std::string>& names) {
+    rules_.push_back({RuleType::REQUIRE_ONE_OF, {}, MakeMask(names)});
+    return *this;
+}
+
+ARGPARSER_INLINE ArgParser& ArgParser::Requires(const std::string& name, const std::vector<std::string>& required_names) {
+    rules_.push_back({RuleType::REQUIRES, MakeMask({name}), MakeMask(required_names)});
+    return *this;
+}
+
+ARGPARSER_INLINE size_t ArgParser::CountSeen(const ArgumentMask& mask) const {
+    size_t count = 0;
+    for (size_t i = 0; i < mask.bits.size(); ++i) {
+        count += std::popcount(seen_[mask.first_word + i] & mask.bits[i]);
+    }
+    return count;
+}
+
+// Имена указанных (seen = true) или пропущенных аргументов из маски
+ARGPARSER_INLINE std::string ArgParser::SeenNames(const ArgumentMask& mask, bool seen) const {
+    std::string names;
+    for (size_t i = 0; i < mask.bits.size(); ++i) {
+        uint64_t bits = mask.bits[i] & (seen ? seen_[mask.first_word + i] : ~seen_[mask.first_word + i]);
+        while (bits) {
+            size_t index = (mask.first_word + i) * 64 + std::countr_zero(bits);
+            bits &= bits - 1;
+            if (!names.empty()) {
+                names += ", ";
             }
+            names += OptionName(ordered_arguments_[index]);
         }
-        // Проверка на короткий аргумент или цепочку коротких флагов
-        else if (arg.rfind("-", 0) == 0 && arg.size() > 1) {
-            for (size_t j = 1; j < arg.size(); ++j) {
-                char short_name = arg[j];
-                if (CheckHelp(std::string(arg))) {
-                    return true;
+    }
+    return names;
+}
+
+ARGPARSER_INLINE bool ArgParser::CheckRules(ParseResult* result) {
+    bool valid = true;
+    for (const auto& rule : rules_) {
+        size_t count = CountSeen(rule.arguments);
+        std::string message;
+        switch (rule.type) {
+            case RuleType::MUTUALLY_EXCLUSIVE:
+                if (count > 1) {
+                    message = SeenNames(rule.arguments, true) + " are mutually exclusive";
                 }
-                if (short_name_map_.find(short_name) == short_name_map_.end()) {
-                    throw std::runtime_error("Unknown argument: -" + std::string(1, short_name));
-                } else {
-                    current_argument = short_name_map_[short_name];
-                    if (current_argument->GetType() != ArgType::BOOL) {
-                        if (j == arg.size() - 1) {
-                            if (i + 1 < argc) {
-                                current_argument->ParseValue(argv[++i]);
-                            }
-                        } else if (arg[j + 1] == '=') {
-                            current_argument->ParseValue(arg.substr(j + 2));
-                            break;
-                        }
-                    } else {
-                        dynamic_cast<TypedArgument<bool>*>(current_argument)->AddValue(true);
-                    }
+                break;
+            case RuleType::REQUIRE_ONE_OF:
+                if (count == 0) {
+                    message = "one of " + SeenNames(rule.arguments, false) + " is required";
                 }
-            }
-            current_argument = nullptr;
-        } else if (current_argument) {
-            current_argument->ParseValue(arg);
-            current_argument = nullptr;
+                break;
+            case RuleType::REQUIRES:
+                if (CountSeen(rule.trigger) != 0 && count != rule.arguments.size) {
+                    message = SeenNames(rule.trigger, true) + " requires " + SeenNames(rule.arguments, false);
+                }
+                break;
         }
-        // Обработка позиционных аргументов
-        else if (positional_index < positional_args.size()) {
-            Argument* positional_arg = positional_args[positional_index];
-            positional_arg->ParseValue(arg);
-            if (!positional_arg->IsMultiValue()) {
-                positional_index++;
+        if (message.empty()) {
+            continue;
+        }
+        if (!result) {
+            return false;
+        }
+        valid = false;
+        result->AddError("", message);
+    }
+    return valid;
+}
+
+ARGPARSER_INLINE ParseResult ArgParser::ValidateAll() {
+    ParseResult result;
+    for (Argument* argument : lazy_arguments_) {
+        argument->Materialize();
+    }
+    CheckConstraints(&result);
+    for (const auto& [name, plugin] : plugins_) {
+        if (plugin.parser) {
+            ParseResult plugin_result = plugin.parser->ValidateAll();
+            for (const ParseError& error : plugin_result.GetErrors()) {
+                result.AddError(error.argument, error.message);
             }
         }
     }
+    return result;
+}
 
-    return CheckMultiValueValid() && CheckValuesValid();
+ARGPARSER_INLINE std::string ArgParser::OptionName(const Argument* argument) const {
+    return "--" + option_prefix_ + argument->GetLongName();
 }
 
-bool ArgParser::CheckHelp(std::string arg) {
+ARGPARSER_INLINE bool ArgParser::CheckHelp(std::string_view arg) {
     if (arg == help_short_ || arg == help_long_)
         return true;
     return false;
 }
 
-bool ArgParser::CheckMultiValueValid() {
-    for (auto& [name, argument] : arguments_) {
+// Проверяются только аргументы, которые могут оказаться без нужных значений,
+// поэтому работа не зависит от общего числа зарегистрированных аргументов
+ARGPARSER_INLINE bool ArgParser::CheckMultiValueValid(ParseResult* result) {
+    CompactRequired();
+    bool valid = true;
+    for (Argument* argument : required_arguments_) {
         if (argument->IsMultiValue() && argument->GetMultiValuesCount() < argument->GetMinMultiValues()) {
-            return false;
+            if (!result) {
+                return false;
+            }
+            valid = false;
+            result->AddError(OptionName(argument), "expected at least " + std::to_string(argument->GetMinMultiValues()) +
+                                                                  " values, got " + std::to_string(argument->GetMultiValuesCount()));
         }
     }
-    return true;
+    return valid;
 }
 
-bool ArgParser::CheckValuesValid() {
-    for (auto& [name, argument] : arguments_) {
-        if (!argument->IsInitialized() && (argument->GetType() != ArgType::BOOL) && argument->GetLongName() != help_long_) {
-            return false;
+ARGPARSER_INLINE bool ArgParser::CheckValuesValid(ParseResult* result) {
+    CompactRequired();
+    bool valid = true;
+    for (Argument* argument : required_arguments_) {
+        if (!argument->IsInitialized() && (argument->GetType() != ArgType::BOOL) && argument != help_argument_) {
+            if (!result) {
+                return false;
+            }
+            valid = false;
+            result->AddError(OptionName(argument), "required argument is missing");
         }
     }
-    return true;
+    return valid;
 }
 
-bool ArgParser::Help() {
+// Нарушения возможны только у аргументов, получивших значения в этом разборе
+// (в том числе у ленивых, преобразованных при обращении)
+ARGPARSER_INLINE bool ArgParser::CheckConstraints(ParseResult* result) {
+    std::vector<std::string> violations;
+    bool valid = true;
+    for (Argument* argument : seen_arguments_) {
+        argument->CollectViolations(violations);
+        if (violations.empty()) {
+            continue;
+        }
+        valid = false;
+        if (result) {
+            for (auto& violation : violations) {
+                result->AddError(OptionName(argument), std::move(violation));
+            }
+        }
+        violations.clear();
+    }
+    return valid;
+}
+
+ARGPARSER_INLINE bool ArgParser::Help() {
     return help_initialized;
 }
 
-ArgParser& ArgParser::AddHelp(const char short_name, const std::string& long_name, const std::string& description) {
+ARGPARSER_INLINE ArgParser& ArgParser::AddHelp(const char short_name, const std::string& long_name, const std::string& description) {
     help_initialized = true;
     help_long_ = long_name;
     help_short_ = short_name;
     help_description_ = description;
-    return AddArgument<std::string>(short_name, long_name, description);
+    AddArgument<std::string>(short_name, long_name, description);
+    help_argument_ = last_added_argument_;
+    return *this;
 }
 
-std::string ArgParser::HelpDescription() {
-    std::ostringstream help;
+ARGPARSER_INLINE std::string ArgParser::HelpDescription() {
+    std::string help;
+    // Около 80 символов на строку справки
+    help.reserve(name_.size() + help_description_.size() + ordered_arguments_.size() * 80);
 
-    help << name_ << "\n";
+    help += name_;
+    help += '\n';
     if (!help_description_.empty()) {
-        help << help_description_ << "\n\n";
+        help += help_description_;
+        help += "\n\n";
     }
 
-    for (const auto& [name, argument] : arguments_) {
-        std::string short_name = argument->GetShortName().empty() ? "" : "-" + argument->GetShortName() + ", ";
-        std::string long_name = "--" + name;
+    std::unordered_map<const Argument*, std::string_view> env_names;
+    for (const auto& [env_name, argument] : env_index_) {
+        env_names[argument] = env_name;
+    }
 
-        help << short_name << long_name;
-        help << ",  " << argument->GetDescription();
+    // Аргументы выводятся в порядке добавления
+    for (const Argument* argument : ordered_arguments_) {
+        std::string short_name = argument->GetShortName();
+        if (short_name[0] != '\0') {
+            help += '-';
+            help += short_name;
+            help += ", ";
+        }
+        help += "--";
+        help += argument->GetLongName();
+        help += ",  ";
+        help += argument->GetDescription();
 
         if (argument->IsMultiValue()) {
-            help << " [MultiValue";
+            help += " [MultiValue";
             if (argument->GetMinMultiValues() > 0) {
-                help << ", min args = " << argument->GetMinMultiValues();
+                help += ", min args = " + std::to_string(argument->GetMinMultiValues());
             }
-            help << "]";
+            help += "]";
         }
 
         if (argument->IsPositional()) {
-            help << " [Positional]";
+            help += " [Positional]";
+        }
+        if (std::string choices = argument->GetChoices(); !choices.empty()) {
+            help += " [choices: " + choices + "]";
+        }
+        if (auto it = env_names.find(argument); it != env_names.end()) {
+            help += " [env: " + env_prefix_;
+            help += it->second;
+            help += "]";
         }
         if (argument->HasDefaultValue()) {
-            auto type = argument->GetType();
-            help << " [default = " << argument->GetDefaultValue() << "]";
+            help += " [default = " + argument->GetDefaultValue() + "]";
         }
 
-        help << "\n";
+        help += '\n';
     }
 
-    return help.str();
+    for (const std::string& plugin_name : plugin_names_) {
+        help += "--" + std::string(kPluginPrefix) + plugin_name + ".*,  " + plugins_.find(plugin_name)->second.description;
+        help += " [Plugin]\n";
+    }
+
+    return help;
 }
+
+}  // namespace ArgumentParser
+
+#ifndef ARGPARSER_HEADER_ONLY
+ARGPARSER_INSTANTIATE(, int)
+ARGPARSER_INSTANTIATE(, std::string)
+ARGPARSER_INSTANTIATE(, bool)
+#endif
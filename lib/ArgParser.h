@@ -1,45 +1,119 @@
 #pragma once
 
+#include <array>
+#include <deque>
+#include <cstdint>
 #include <fstream>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "ChoiceArgument.h"
+#include "CountArgument.h"
+#include "EditDistance.h"
+#include "ParseResult.h"
 #include "TypedArgument.h"
 
+/*
+    ARGPARSER_HEADER_ONLY - определения из ArgParser.cpp подключаются в этот
+    заголовок как inline (цель argparser_header_only), и компилятор может
+    встраивать их в код пользователя.
+    ARGPARSER_NO_EXTERN_TEMPLATES - не объявлять extern template для типов
+    int, std::string и bool, которые уже инстанцированы в библиотеке argparser
+*/
+#ifdef ARGPARSER_HEADER_ONLY
+#define ARGPARSER_INLINE inline
+#else
+#define ARGPARSER_INLINE
+#endif
+
 namespace ArgumentParser {
 
+// Хеш для поиска в словаре по std::string_view без создания строки
+struct StringHash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view value) const { return std::hash<std::string_view>{}(value); }
+};
+
 class ArgParser {
    public:
+    // Настройка парсера плагина, вызывается при первом упоминании плагина
+    using PluginFactory = std::function<void(ArgParser&)>;
+
     // Конструктор, деструктор
     ArgParser(const std::string& name) : name_(name) {};
     ~ArgParser() {
-        for (auto& [key, value] : arguments_) {
-            delete value;
+        for (Argument* argument : ordered_arguments_) {
+            argument->~Argument();
         }
     }
 
+    // Резервирование памяти под count аргументов перед массовой регистрацией
+    ArgParser& Reserve(size_t count);
+
     ArgParser& AddStringArgument(const char short_name_, const std::string& long_name_, const std::string& description = "");
     ArgParser& AddStringArgument(const std::string& long_name_, const std::string& description = "");
     ArgParser& AddIntArgument(char short_name_, const std::string& long_name_, const std::string& description = "");
     ArgParser& AddIntArgument(const std::string& long_name_, const std::string& description = "");
     ArgParser& AddFlag(char short_name_, const std::string& long_name_, const std::string& description = "");
     ArgParser& AddFlag(const std::string& long_name_, const std::string& description = "");
+    // Флаг-счетчик, значение читается как int: -vvv -> 3
+    ArgParser& AddCountFlag(char short_name, const std::string& long_name, const std::string& description = "");
+    ArgParser& AddCountFlag(const std::string& long_name, const std::string& description = "");
 
     template <typename T>
     ArgParser& AddArgument(char short_name, const std::string& long_name, const std::string& description = "");
     template <typename T>
     ArgParser& AddArgument(const std::string& long_name, const std::string& description = "");
 
+    // Аргумент-выбор: строка из списка отображается в значение E при разборе
+    template <typename E>
+    ArgParser& AddChoiceArgument(char short_name, const std::string& long_name,
+                                 std::initializer_list<std::pair<std::string_view, E>> choices,
+                                 const std::string& description = "");
+    template <typename E>
+    ArgParser& AddChoiceArgument(const std::string& long_name,
+                                 std::initializer_list<std::pair<std::string_view, E>> choices,
+                                 const std::string& description = "");
+
+    template <typename T>
+    ArgParser& MakeDefault(const T& value);
     template <typename T>
-    ArgParser& MakeDefault(T& values);
+    ArgParser& Default(const T& value) { return MakeDefault(value); }
     ArgParser& Default(const char* value);
     ArgParser& Default(int value);
     ArgParser& Default(bool value);
 
+    // Ограничения на значения, проверяются во время Parse
+    template <typename T>
+    ArgParser& Min(const T& value);
+    template <typename T>
+    ArgParser& Max(const T& value);
+    template <typename T>
+    ArgParser& Check(std::function<bool(const T&)> predicate, const std::string& message);
+    ArgParser& NonEmpty(bool value = true);
+
+    // Значение из переменной окружения, если аргумент не задан в командной строке.
+    // По умолчанию имя строится из длинного имени: "log-level" -> LOG_LEVEL
+    ArgParser& Env(const std::string& name = "");
+    ArgParser& EnvPrefix(const std::string& prefix);
+
+    // Правила для групп аргументов, проверяются в конце Parse.
+    // Аргумент считается указанным, если получил значение из командной строки или окружения
+    ArgParser& MutuallyExclusive(const std::vector<std::string>& names);
+    ArgParser& RequireOneOf(const std::vector<std::string>& names);
+    ArgParser& Requires(const std::string& name, const std::vector<std::string>& required_names);
+
     ArgParser& Positional(bool value = true);
+    // Значения преобразуются при первом обращении, а не во время Parse
+    ArgParser& Lazy(bool value = true);
     ArgParser& MultiValue(int min_values = INT_MIN);
 
     template <typename T>
@@ -47,12 +121,18 @@ class ArgParser {
     ArgParser& StoreValues(std::vector<int>& values);
     ArgParser& StoreValues(std::vector<std::string>& values);
     ArgParser& StoreValues(std::vector<bool>& values);
+    // Строковые значения MultiValue в общем непрерывном буфере
+    ArgParser& StoreValues(StringPool& values);
+    template <typename T>
+    ArgParser& StoreValues(std::vector<T>& values) { return MakeStoreValues(values); }
 
     template <typename T>
     ArgParser& MakeStoreValue(T& value);
     ArgParser& StoreValue(std::string& value);
     ArgParser& StoreValue(bool& value);
     ArgParser& StoreValue(int& value);
+    template <typename T>
+    ArgParser& StoreValue(T& value) { return MakeStoreValue(value); }
 
     int GetIntValue(const std::string& argument, const int& multi_value = 0);
     int GetIntValue(const char& argument, const int& multi_value = 0);
@@ -63,6 +143,11 @@ class ArgParser {
     bool GetFlag(const std::string& argument, const int& multi_value = 0);
     bool GetFlag(const char& argument, const int& multi_value = 0);
 
+    // Значения всех флагов из AddFlag одним битовым набором:
+    // бит FlagBit(name) установлен, если флаг включен в последнем разборе
+    const std::vector<uint64_t>& GetFlags() const;
+    size_t FlagBit(const std::string& long_name) const;
+
     template <typename T>
     T GetValue(const std::string& long_name);
     template <typename T>
@@ -71,10 +156,10 @@ class ArgParser {
     // Получение аргументов
     template <typename T>
     TypedArgument<T>& GetArgument(const std::string& long_name) {
-        if (arguments_.find(long_name) == arguments_.end())
+        auto it = arguments_.find(long_name);
+        if (it == arguments_.end())
             throw std::invalid_argument("Argument not found");
-        Argument* arg = arguments_[long_name];
-        auto* typedArg = dynamic_cast<TypedArgument<T>*>(arg);
+        auto* typedArg = dynamic_cast<TypedArgument<T>*>(it->second);
         if (!typedArg)
             throw std::bad_cast();
         return *typedArg;
@@ -82,10 +167,10 @@ class ArgParser {
 
     template <typename T>
     TypedArgument<T>& GetArgument(const char& short_name) {
-        if (short_name_map_.find(short_name) == short_name_map_.end())
+        Argument* arg = short_names_[static_cast<unsigned char>(short_name)];
+        if (!arg)
             throw std::invalid_argument("Argument not found");
 
-        Argument* arg = short_name_map_[short_name];
         auto* typedArg = dynamic_cast<TypedArgument<T>*>(arg);
         if (!typedArg)
             throw std::bad_cast();
@@ -93,27 +178,324 @@ class ArgParser {
         return *typedArg;
     }
 
-    int Parse(const std::vector<std::string>& parse_values);
-    int Parse(int argc, char** argv);
-    bool CheckMultiValueValid();
-    bool CheckValuesValid();
-    bool ParseLongArgument(std::string arg, Argument*& current_argument);
+    ParseResult Parse(const std::vector<std::string>& parse_values);
+    ParseResult Parse(int argc, char** argv);
+
+    // Пошаговый разбор: токены подаются по одному (без имени программы),
+    // Finish проверяет результат так же, как Parse
+    void Feed(std::string_view arg);
+    ParseResult Finish();
+
+    // Неизвестные опции, лишние позиционные значения и все после "--"
+    // не вызывают ошибку, а попадают в остаток в исходном порядке.
+    // Остаток ссылается на токены разбора и действителен до следующего Parse
+    ArgParser& AllowUnknownArguments(bool value = true);
+    const std::vector<std::string_view>& GetRemainder() const;
+    bool CheckMultiValueValid(ParseResult* result = nullptr);
+    bool CheckValuesValid(ParseResult* result = nullptr);
+    bool CheckConstraints(ParseResult* result = nullptr);
+    bool CheckRules(ParseResult* result = nullptr);
+    bool ParseLongArgument(std::string_view arg, Argument*& current_argument);
+    // Преобразование всех отложенных значений ленивых аргументов
+    ParseResult ValidateAll();
+
+    // Подсказка для неизвестного имени: "--name" или пустая строка
+    std::string SuggestArgument(std::string_view name);
+
+    // Опции вида --plugin.name.option=value разбирает отдельный парсер плагина.
+    // Он создается фабрикой только когда плагин встретился в командной строке
+    // (или при вызове GetPlugin), остальные плагины ничего не стоят
+    ArgParser& AddPlugin(const std::string& name, PluginFactory factory, const std::string& description = "");
+    ArgParser& GetPlugin(const std::string& name);
+    bool IsPluginLoaded(const std::string& name) const;
 
     bool Help();
     ArgParser& AddHelp(const char short_name_, const std::string& long_name_, const std::string& description = "^_^");
     std::string HelpDescription();
-    bool CheckHelp(std::string arg);
+    bool CheckHelp(std::string_view arg);
 
    private:
+    enum class RuleType { MUTUALLY_EXCLUSIVE,
+                          REQUIRE_ONE_OF,
+                          REQUIRES };
+
+    // Маска аргументов по словам [first_word, first_word + bits.size())
+    struct ArgumentMask {
+        size_t first_word = 0;
+        size_t size = 0;
+        std::vector<uint64_t> bits;
+    };
+
+    struct Rule {
+        RuleType type;
+        ArgumentMask trigger;
+        ArgumentMask arguments;
+    };
+
+    struct Plugin {
+        PluginFactory factory;
+        std::string description;
+        std::unique_ptr<ArgParser> parser;
+    };
+
+    static constexpr std::string_view kPluginPrefix = "plugin.";
+
+    ArgumentMask MakeMask(const std::vector<std::string>& names);
+    size_t CountSeen(const ArgumentMask& mask) const;
+    std::string SeenNames(const ArgumentMask& mask, bool seen) const;
+
+    // Аргументы, имена и описания размещаются в общей арене парсера
+    std::pmr::monotonic_buffer_resource& Arena();
+    std::string_view StoreString(std::string_view text);
+    template <typename A, typename... Args>
+    A* NewArgument(Args&&... args) {
+        return new (Arena().allocate(sizeof(A), alignof(A))) A(std::forward<Args>(args)...);
+    }
+
+    ArgParser& RegisterArgument(Argument* arg, const std::string& long_name, const std::string& description);
+    bool IsRequiredCandidate(const Argument* argument) const;
+    void CompactRequired();
+    ArgParser& RegisterShortName(char short_name);
+    void FeedToken(std::string_view arg);
+    void BeginParse();
+    void DiscardPending();
+    void MarkSeen(Argument* argument);
+    bool IsSeen(const Argument* argument) const;
+    void ApplyValue(Argument* argument, std::string_view value);
+    void AddToRemainder(std::string_view arg);
+    void ApplyFlag(Argument* argument);
+    void SetFlagBits(size_t word, uint64_t mask);
+    static void AssignFlagBit(std::vector<uint64_t>& bits, uint32_t slot, bool value);
+    bool ReadFlag(TypedArgument<bool>& argument);
+    void ResetFlags();
+    void ResolveEnvironment();
+    bool ParseLongOption(std::string_view arg, std::string_view long_name, std::optional<std::string_view> value,
+                         Argument*& current_argument);
+    bool ParsePluginArgument(std::string_view arg, std::string_view plugin_name, std::string_view option,
+                             std::optional<std::string_view> value);
+    ArgParser& LoadPlugin(std::string_view name, Plugin& plugin);
+    std::string OptionName(const Argument* argument) const;
+    bool ParseShortArguments(std::string_view arg);
+    bool IsKnownShortCluster(std::string_view arg) const;
+    std::string SuggestShortArgument(std::string_view arg, char short_name);
+    static std::string SuggestionMessage(const std::string& suggestion);
+
     std::string name_;
-    std::unordered_map<std::string, Argument*> arguments_;
-    std::unordered_map<char, Argument*> short_name_map_;
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+    size_t reserved_count_ = 0;
+
+    std::unordered_map<std::string_view, Argument*, StringHash, std::equal_to<>> arguments_;
+    std::array<Argument*, 256> short_names_{};
+    std::vector<Argument*> ordered_arguments_;
+    // Аргументы, которые могут не пройти проверку без значения в командной строке
+    std::vector<Argument*> required_arguments_;
+    std::vector<Argument*> positional_arguments_;
+    std::vector<std::string_view> suggestion_names_;
+    std::vector<Argument*> lazy_arguments_;
+    std::vector<std::string> owned_args_;
+
+    // Состояние разбора между вызовами Feed
+    size_t positional_index_ = 0;
+    Argument* current_argument_ = nullptr;
+    bool awaiting_value_ = false;
+    bool parsing_ = false;
+    bool help_requested_ = false;
+    // Копии токенов ленивых аргументов и остатка, поданных через Feed (адреса в deque не меняются)
+    bool copy_tokens_ = false;
+    std::deque<std::string> fed_tokens_;
+
+    bool allow_unknown_ = false;
+    bool passthrough_ = false;
+    std::vector<std::string_view> remainder_;
+
+    // Обычные флаги хранятся битами в flags_. Для каждого аргумента (по индексу)
+    // flag_slots_ содержит номер бита флага (меньше kCountFlag), kCountFlag или kNotFlag
+    static constexpr uint32_t kNotFlag = UINT32_MAX;
+    static constexpr uint32_t kCountFlag = UINT32_MAX - 1;
+    std::vector<uint32_t> flag_slots_;
+    std::vector<uint64_t> flags_;
+    std::vector<uint64_t> flag_defaults_;
+    // Биты флагов со StoreValue и аргументы флагов по номеру бита
+    std::vector<uint64_t> flag_stores_;
+    std::vector<TypedArgument<bool>*> flag_arguments_;
+    size_t flag_count_ = 0;
+    std::vector<CountArgument*> counters_;
+
+    // Аргументы, получившие значение в текущем разборе (битовая маска по индексам)
+    std::vector<uint64_t> seen_;
+    std::vector<Argument*> seen_arguments_;
+
+    std::vector<Rule> rules_;
+
+    std::unordered_map<std::string, Plugin, StringHash, std::equal_to<>> plugins_;
+    std::vector<std::string> plugin_names_;
+    std::vector<ArgParser*> active_plugins_;
+    ArgParser* current_plugin_ = nullptr;
+    // Префикс имен в сообщениях: "plugin.name." у парсера плагина
+    std::string option_prefix_;
+
+    std::string env_prefix_;
+    std::unordered_map<std::string, Argument*, StringHash, std::equal_to<>> env_index_;
     Argument* last_added_argument_ = nullptr;
 
+    Argument* help_argument_ = nullptr;
     std::string help_short_;
     std::string help_long_;
     std::string help_description_;
     bool help_initialized = false;
 };
 
+template <typename T>
+ArgParser& ArgParser::AddArgument(char short_name, const std::string& long_name, const std::string& description) {
+    AddArgument<T>(long_name, description);
+    return RegisterShortName(short_name);
+}
+
+template <typename T>
+ArgParser& ArgParser::AddArgument(const std::string& long_name, const std::string& description) {
+    return RegisterArgument(NewArgument<TypedArgument<T>>(), long_name, description);
+}
+
+template <typename E>
+ArgParser& ArgParser::AddChoiceArgument(char short_name, const std::string& long_name,
+                                        std::initializer_list<std::pair<std::string_view, E>> choices,
+                                        const std::string& description) {
+    AddChoiceArgument(long_name, choices, description);
+    return RegisterShortName(short_name);
+}
+
+template <typename E>
+ArgParser& ArgParser::AddChoiceArgument(const std::string& long_name,
+                                        std::initializer_list<std::pair<std::string_view, E>> choices,
+                                        const std::string& description) {
+    return RegisterArgument(NewArgument<ChoiceArgument<E>>(choices), long_name, description);
+}
+
+template <typename T>
+ArgParser& ArgParser::MakeDefault(const T& value) {
+    if (!last_added_argument_) {
+        throw std::runtime_error("No argument added to configure.");
+    }
+
+    auto* typed_arg = dynamic_cast<TypedArgument<T>*>(last_added_argument_);
+    if (typed_arg) {
+        typed_arg->SetDefault(value);
+        return *this;
+    }
+
+    throw std::invalid_argument("Argument does not support default values of this type.");
+}
+
+template <typename T>
+ArgParser& ArgParser::MakeStoreValues(std::vector<T>& values) {
+    if (!last_added_argument_) {
+        throw std::runtime_error("No argument added to configure.");
+    }
+
+    auto* typed_arg = dynamic_cast<TypedArgument<T>*>(last_added_argument_);
+    if (!typed_arg) {
+        throw std::invalid_argument("Argument does not support storing values of this type.");
+    }
+
+    typed_arg->StoreValues(values);
+    return *this;
+}
+
+template <typename T>
+ArgParser& ArgParser::MakeStoreValue(T& value) {
+    if (!last_added_argument_) {
+        throw std::runtime_error("No argument added to configure.");
+    }
+
+    auto* typed_arg = dynamic_cast<TypedArgument<T>*>(last_added_argument_);
+    if (!typed_arg) {
+        throw std::invalid_argument("Argument does not support storing value of this type.");
+    }
+
+    typed_arg->StoreValue(value);
+    return *this;
+}
+
+template <typename T>
+ArgParser& ArgParser::Min(const T& value) {
+    if (!last_added_argument_) {
+        throw std::runtime_error("No argument added to configure.");
+    }
+
+    auto* typed_arg = dynamic_cast<TypedArgument<T>*>(last_added_argument_);
+    if (!typed_arg) {
+        throw std::invalid_argument("Argument does not support constraints of this type.");
+    }
+
+    typed_arg->SetMin(value);
+    return *this;
+}
+
+template <typename T>
+ArgParser& ArgParser::Max(const T& value) {
+    if (!last_added_argument_) {
+        throw std::runtime_error("No argument added to configure.");
+    }
+
+    auto* typed_arg = dynamic_cast<TypedArgument<T>*>(last_added_argument_);
+    if (!typed_arg) {
+        throw std::invalid_argument("Argument does not support constraints of this type.");
+    }
+
+    typed_arg->SetMax(value);
+    return *this;
+}
+
+template <typename T>
+ArgParser& ArgParser::Check(std::function<bool(const T&)> predicate, const std::string& message) {
+    if (!last_added_argument_) {
+        throw std::runtime_error("No argument added to configure.");
+    }
+
+    auto* typed_arg = dynamic_cast<TypedArgument<T>*>(last_added_argument_);
+    if (!typed_arg) {
+        throw std::invalid_argument("Argument does not support constraints of this type.");
+    }
+
+    typed_arg->AddCheck(std::move(predicate), message);
+    return *this;
+}
+
+template <typename T>
+T ArgParser::GetValue(const std::string& long_name) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return ReadFlag(GetArgument<bool>(long_name));
+    }
+    return GetArgument<T>(long_name).GetValue();
+}
+
+template <typename T>
+T ArgParser::GetValue(const char& short_name) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return ReadFlag(GetArgument<bool>(short_name));
+    }
+    return GetArgument<T>(short_name).GetValue();
+}
+
 }  // namespace ArgumentParser
+
+// Шаблоны, которые использует сама библиотека
+#define ARGPARSER_INSTANTIATE(PREFIX, T) \
+    PREFIX template class TypedArgument<T>; \
+    PREFIX template ArgumentParser::ArgParser& ArgumentParser::ArgParser::AddArgument<T>(char, const std::string&, const std::string&); \
+    PREFIX template ArgumentParser::ArgParser& ArgumentParser::ArgParser::AddArgument<T>(const std::string&, const std::string&); \
+    PREFIX template ArgumentParser::ArgParser& ArgumentParser::ArgParser::MakeDefault<T>(const T&); \
+    PREFIX template ArgumentParser::ArgParser& ArgumentParser::ArgParser::MakeStoreValues<T>(std::vector<T>&); \
+    PREFIX template ArgumentParser::ArgParser& ArgumentParser::ArgParser::MakeStoreValue<T>(T&); \
+    PREFIX template T ArgumentParser::ArgParser::GetValue<T>(const std::string&); \
+    PREFIX template T ArgumentParser::ArgParser::GetValue<T>(const char&);
+
+#if !defined(ARGPARSER_HEADER_ONLY) && !defined(ARGPARSER_NO_EXTERN_TEMPLATES)
+ARGPARSER_INSTANTIATE(extern, int)
+ARGPARSER_INSTANTIATE(extern, std::string)
+ARGPARSER_INSTANTIATE(extern, bool)
+#endif
+
+#ifdef ARGPARSER_HEADER_ONLY
+#include "ArgParser.cpp"
+#endif
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <cstdint>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
+
 // Класс для указания типов аргументов
-enum class ArgType { STRING,
-                     INT,
-                     BOOL };
+enum class ArgType : uint8_t { STRING,
+                               INT,
+                               BOOL,
+                               CUSTOM };
 
 // Базовый класс для всех аргументов
 class Argument {
@@ -12,14 +18,29 @@ class Argument {
     virtual ~Argument() = default;
     virtual ArgType GetType() const = 0;
 
-    virtual void ParseValue(const std::string& value) = 0;
+    virtual void ParseValue(std::string_view value) = 0;
+
+    // Порядковый номер аргумента в парсере
+    virtual void SetIndex(size_t index) = 0;
+    virtual size_t GetIndex() const = 0;
 
-    virtual void SetLongName(std::string long_name) = 0;
+    virtual void SetLongName(std::string_view long_name) = 0;
     virtual void SetShortName(char short_name) = 0;
-    virtual void SetDescription(std::string description) = 0;
+    virtual void SetDescription(std::string_view description) = 0;
 
     virtual void SetMultiValue(int min_values) = 0;
     virtual void SetPositional(bool value) = 0;
+    virtual void SetLazy(bool value) = 0;
+    virtual void SetNonEmpty(bool value) = 0;
+
+    // Преобразование отложенных значений (для ленивых аргументов)
+    virtual void Materialize() = 0;
+    // Отбросить отложенные значения без преобразования (новый разбор)
+    virtual void DiscardPending() = 0;
+    virtual void ClearValues() = 0;
+    // Перенос накопленных нарушений ограничений в violations
+    virtual void CollectViolations(std::vector<std::string>& violations) = 0;
+    virtual void ClearViolations() = 0;
 
     virtual int GetMultiValuesCount() const = 0;
     virtual int GetMinMultiValues() const = 0;
@@ -27,9 +48,11 @@ class Argument {
     virtual std::string GetLongName() const = 0;
     virtual std::string GetDescription() const = 0;
     virtual std::string GetDefaultValue() const = 0;
+    virtual std::string GetChoices() const { return ""; }
 
     virtual bool IsPositional() const = 0;
     virtual bool IsMultiValue() const = 0;
+    virtual bool IsLazy() const = 0;
     virtual bool IsInitialized() const = 0;
     virtual bool HasDefaultValue() const = 0;
 
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "TypedArgument.h"
+
+namespace ArgumentParser {
+
+/*
+    Таблица допустимых строк для аргумента-выбора.
+    При построении подбирается seed, при котором хеш всех строк попадает
+    в разные ячейки (совершенное хеширование), поэтому поиск - это один
+    хеш и одно сравнение строк
+*/
+template <typename E>
+class ChoiceTable {
+   public:
+    ChoiceTable(std::initializer_list<std::pair<std::string_view, E>> choices) {
+        entries_.reserve(choices.size());
+        for (const auto& [name, value] : choices) {
+            for (const auto& entry : entries_) {
+                if (entry.name == name) {
+                    throw std::invalid_argument("Duplicate choice: " + std::string(name));
+                }
+            }
+            entries_.push_back({std::string(name), value});
+        }
+        if (entries_.empty()) {
+            throw std::invalid_argument("Choice argument requires at least one choice.");
+        }
+        Build();
+    }
+
+    const E* Find(std::string_view name) const {
+        uint16_t slot = slots_[Hash(name, seed_) & mask_];
+        if (slot == 0 || entries_[slot - 1].name != name) {
+            return nullptr;
+        }
+        return &entries_[slot - 1].value;
+    }
+
+    bool Contains(const E& value) const {
+        return std::any_of(entries_.begin(), entries_.end(), [&value](const Entry& entry) { return entry.value == value; });
+    }
+
+    std::string_view NameOf(const E& value) const {
+        for (const auto& entry : entries_) {
+            if (entry.value == value) {
+                return entry.name;
+            }
+        }
+        return {};
+    }
+
+    std::string Names() const {
+        std::string names;
+        for (const auto& entry : entries_) {
+            if (!names.empty()) {
+                names += '|';
+            }
+            names += entry.name;
+        }
+        return names;
+    }
+
+   private:
+    struct Entry {
+        std::string name;
+        E value;
+    };
+
+    static uint32_t Hash(std::string_view name, uint32_t seed) {
+        uint32_t hash = 2166136261u ^ seed;
+        for (char c : name) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 16777619u;
+        }
+        return hash ^ (hash >> 15);
+    }
+
+    void Build() {
+        size_t size = 2;
+        while (size < entries_.size() * 2) {
+            size *= 2;
+        }
+
+        for (;; size *= 2) {
+            slots_.assign(size, 0);
+            mask_ = static_cast<uint32_t>(size - 1);
+            for (seed_ = 0; seed_ < 256; ++seed_) {
+                if (TryPlace()) {
+                    return;
+                }
+            }
+        }
+    }
+
+    bool TryPlace() {
+        std::fill(slots_.begin(), slots_.end(), 0);
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            uint16_t& slot = slots_[Hash(entries_[i].name, seed_) & mask_];
+            if (slot != 0) {
+                return false;
+            }
+            slot = static_cast<uint16_t>(i + 1);
+        }
+        return true;
+    }
+
+    std::vector<Entry> entries_;
+    std::vector<uint16_t> slots_;
+    uint32_t seed_ = 0;
+    uint32_t mask_ = 0;
+};
+
+// Аргумент, принимающий одно из фиксированного набора значений
+template <typename E>
+class ChoiceArgument : public TypedArgument<E> {
+   public:
+    ChoiceArgument(std::initializer_list<std::pair<std::string_view, E>> choices) : table_(choices) {}
+
+    // Значение по умолчанию тоже должно быть одним из вариантов
+    void SetDefault(const E& value) override {
+        if (!table_.Contains(value)) {
+            throw std::invalid_argument("Default value of argument " + this->GetLongName() +
+                                        " is not one of: " + table_.Names());
+        }
+        TypedArgument<E>::SetDefault(value);
+    }
+
+    std::string GetDefaultValue() const override {
+        if (!this->HasDefaultValue()) {
+            throw std::runtime_error("Default value is not set.");
+        }
+        return std::string(table_.NameOf(this->GetDefault()));
+    }
+
+    std::string GetChoices() const override {
+        return table_.Names();
+    }
+
+   protected:
+    void ConvertValue(std::string_view value) override {
+        const E* choice = table_.Find(value);
+        if (!choice) {
+            throw std::invalid_argument("Invalid value '" + std::string(value) + "' for argument " +
+                                        this->GetLongName() + ", expected one of: " + table_.Names());
+        }
+        this->AcceptValue(*choice);
+    }
+
+   private:
+    ChoiceTable<E> table_;
+};
+
+}  // namespace ArgumentParser
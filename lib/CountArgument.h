@@ -0,0 +1,43 @@
+#pragma once
+
+#include "TypedArgument.h"
+
+namespace ArgumentParser {
+
+// Флаг-счетчик: каждое появление (-vvv, --verbose --verbose) увеличивает
+// значение на единицу. Явное значение (--verbose=2) задает его напрямую.
+// Ограничения (Min, Max, Check) проверяются один раз для итогового счета
+class CountArgument : public TypedArgument<int> {
+   public:
+    CountArgument() : TypedArgument<int>(ArgType::BOOL) {}
+
+    void Increment() {
+        AddValue(GetValue() + 1);
+        counted_ = true;
+    }
+
+    // Счет начинается заново в каждом разборе
+    void Reset() {
+        SetValue(HasDefaultValue() ? GetDefault() : 0);
+        counted_ = false;
+    }
+
+    void CollectViolations(std::vector<std::string>& violations) override {
+        if (counted_) {
+            counted_ = false;
+            CheckValue(GetValue());
+        }
+        TypedArgument<int>::CollectViolations(violations);
+    }
+
+   protected:
+    void ConvertValue(std::string_view value) override {
+        AddValue(ParseToken(value));
+        counted_ = true;
+    }
+
+   private:
+    bool counted_ = false;
+};
+
+}  // namespace ArgumentParser
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+/*
+    Расстояние Левенштейна от фиксированного шаблона до произвольных строк.
+    Для шаблонов до 64 символов используется битово-параллельный алгоритм
+    Майерса в варианте Хююрё: одна строка обрабатывается за O(|text|) операций
+    над 64-битными словами. Маски символов шаблона строятся один раз
+    в конструкторе. Более длинные шаблоны считаются обычной динамикой
+*/
+class EditDistance {
+   public:
+    explicit EditDistance(std::string_view pattern) : pattern_(pattern) {
+        peq_.fill(0);
+        if (pattern_.size() <= 64) {
+            for (size_t i = 0; i < pattern_.size(); ++i) {
+                peq_[static_cast<unsigned char>(pattern_[i])] |= uint64_t{1} << i;
+            }
+        }
+    }
+
+    size_t Distance(std::string_view text) const {
+        if (pattern_.empty()) {
+            return text.size();
+        }
+        if (pattern_.size() > 64) {
+            return DistanceSlow(text);
+        }
+
+        const uint64_t last = uint64_t{1} << (pattern_.size() - 1);
+        uint64_t pv = ~uint64_t{0};
+        uint64_t mv = 0;
+        size_t score = pattern_.size();
+
+        for (char c : text) {
+            uint64_t eq = peq_[static_cast<unsigned char>(c)];
+            uint64_t xv = eq | mv;
+            uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+            if (ph & last) {
+                ++score;
+            } else if (mh & last) {
+                --score;
+            }
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+        }
+        return score;
+    }
+
+   private:
+    size_t DistanceSlow(std::string_view text) const {
+        std::vector<size_t> row(text.size() + 1);
+        std::iota(row.begin(), row.end(), 0);
+        for (size_t i = 1; i <= pattern_.size(); ++i) {
+            size_t diagonal = row[0];
+            row[0] = i;
+            for (size_t j = 1; j <= text.size(); ++j) {
+                size_t above = row[j];
+                row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (pattern_[i - 1] != text[j - 1])});
+                diagonal = above;
+            }
+        }
+        return row[text.size()];
+    }
+
+    std::string_view pattern_;
+    std::array<uint64_t, 256> peq_;
+};
+
+}  // namespace ArgumentParser
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ArgumentParser {
+
+// Описание ошибки разбора: имя аргумента (--name) и текст
+struct ParseError {
+    std::string argument;
+    std::string message;
+};
+
+/*
+    Результат разбора. Приводится к bool, поэтому старый код вида
+    if (!parser.Parse(argc, argv)) продолжает работать, а причины
+    ошибок доступны через GetErrors()
+*/
+class ParseResult {
+   public:
+    ParseResult(bool success = true) : success_(success) {}
+
+    operator bool() const { return success_ && errors_.empty(); }
+
+    void AddError(std::string argument, std::string message) {
+        errors_.push_back({std::move(argument), std::move(message)});
+    }
+
+    const std::vector<ParseError>& GetErrors() const { return errors_; }
+
+    std::string ErrorMessage() const {
+        std::string message;
+        for (const auto& error : errors_) {
+            if (!message.empty()) {
+                message += '\n';
+            }
+            message += error.argument.empty() ? error.message : error.argument + ": " + error.message;
+        }
+        return message;
+    }
+
+   private:
+    bool success_;
+    std::vector<ParseError> errors_;
+};
+
+}  // namespace ArgumentParser
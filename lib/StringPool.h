@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+/*
+    Хранилище строк в одном непрерывном буфере.
+    Строки дописываются в bytes_, границы хранятся в offsets_.
+    При включенном интернировании одинаковые строки хранятся один раз,
+    а для каждого добавленного значения запоминается номер строки в ids_
+*/
+class StringPool {
+   public:
+    class Iterator {
+       public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        Iterator() = default;
+        Iterator(const StringPool* pool, size_t index) : pool_(pool), index_(index) {}
+
+        std::string_view operator*() const { return (*pool_)[index_]; }
+        std::string_view operator[](difference_type n) const { return (*pool_)[index_ + n]; }
+
+        Iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator copy = *this;
+            ++index_;
+            return copy;
+        }
+        Iterator& operator--() {
+            --index_;
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator copy = *this;
+            --index_;
+            return copy;
+        }
+        Iterator& operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+        Iterator& operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+        friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        bool operator==(const Iterator& other) const { return index_ == other.index_; }
+        auto operator<=>(const Iterator& other) const { return index_ <=> other.index_; }
+
+       private:
+        const StringPool* pool_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    explicit StringPool(bool intern = false) : intern_(intern) {}
+
+    void Reserve(size_t count, size_t total_bytes) {
+        bytes_.reserve(total_bytes);
+        offsets_.reserve(count + 1);
+        if (intern_) {
+            ids_.reserve(count);
+        }
+    }
+
+    void Append(std::string_view value) {
+        if (bytes_.size() + value.size() > UINT32_MAX) {
+            throw std::length_error("StringPool exceeds 4 GiB.");
+        }
+        if (!intern_) {
+            AppendUnique(value);
+            return;
+        }
+
+        if ((UniqueCount() + 1) * 2 > table_.size()) {
+            Rehash(table_.empty() ? 16 : table_.size() * 2);
+        }
+        size_t slot = FindSlot(value);
+        if (table_[slot] == kEmpty) {
+            table_[slot] = static_cast<uint32_t>(UniqueCount());
+            AppendUnique(value);
+        }
+        ids_.push_back(table_[slot]);
+    }
+
+    std::string_view operator[](size_t index) const {
+        return Unique(intern_ ? ids_[index] : index);
+    }
+
+    size_t size() const { return intern_ ? ids_.size() : UniqueCount(); }
+    bool empty() const { return size() == 0; }
+
+    // Количество различных строк (без интернирования совпадает с size())
+    size_t UniqueCount() const { return offsets_.size() - 1; }
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, size()); }
+
+    void clear() {
+        bytes_.clear();
+        offsets_.assign(1, 0);
+        ids_.clear();
+        table_.clear();
+    }
+
+    // Объем занятой памяти в байтах, включая зарезервированную
+    size_t MemoryUsage() const {
+        return bytes_.capacity() + offsets_.capacity() * sizeof(uint32_t) + ids_.capacity() * sizeof(uint32_t) +
+               table_.capacity() * sizeof(uint32_t);
+    }
+
+   private:
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+
+    std::string_view Unique(size_t index) const {
+        return std::string_view(bytes_.data() + offsets_[index], offsets_[index + 1] - offsets_[index]);
+    }
+
+    void AppendUnique(std::string_view value) {
+        bytes_.append(value);
+        offsets_.push_back(static_cast<uint32_t>(bytes_.size()));
+    }
+
+    size_t FindSlot(std::string_view value) const {
+        size_t mask = table_.size() - 1;
+        size_t slot = std::hash<std::string_view>{}(value) & mask;
+        while (table_[slot] != kEmpty && Unique(table_[slot]) != value) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void Rehash(size_t size) {
+        table_.assign(size, kEmpty);
+        for (uint32_t id = 0; id < UniqueCount(); ++id) {
+            table_[FindSlot(Unique(id))] = id;
+        }
+    }
+
+    bool intern_;
+    std::string bytes_;
+    std::vector<uint32_t> offsets_{0};
+    std::vector<uint32_t> ids_;
+    std::vector<uint32_t> table_;
+};
+
+}  // namespace ArgumentParser
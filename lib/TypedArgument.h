@@ -1,20 +1,37 @@
 #pragma once
 
+#include <climits>
+#include <concepts>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "Argument.h"
+#include "StringPool.h"
+#include "ValueTraits.h"
 
 template <typename T>
 class TypedArgument : public Argument {
    public:
-    TypedArgument(ArgType type) : type_(type) {}
+    using Traits = ArgumentParser::ValueTraits<T>;
 
-    void SetLongName(std::string long_name) { long_name_ = long_name; }
-    void SetShortName(char short_name) { short_name_ = short_name; }
-    void SetDescription(std::string description) { description_ = description; }
+    TypedArgument(ArgType type = ArgumentParser::ArgTypeOf<T>()) : type_(type) {}
+
+    void SetIndex(size_t index) override { index_ = static_cast<uint32_t>(index); }
+    size_t GetIndex() const override { return index_; }
+
+    // Строки имени и описания хранит владелец аргумента (ArgParser)
+    void SetLongName(std::string_view long_name) override { long_name_ = long_name; }
+    void SetShortName(char short_name) override { short_name_ = short_name; }
+    void SetDescription(std::string_view description) override { description_ = description; }
     void SetValue(const T& value) {
         value_ = value;
         if (external_value_) {
@@ -22,10 +39,16 @@ class TypedArgument : public Argument {
         }
     }
 
-    void AddValue(const T& value) {
+    void AddValue(T value) {
         is_initialized_ = true;
+        if constexpr (std::is_same_v<T, std::string>) {
+            if (is_multi_value_ && extra_ && extra_->string_pool) {
+                extra_->string_pool->Append(value);
+                return;
+            }
+        }
         if (is_multi_value_){
-            multi_values_->push_back(value);}
+            multi_values_->push_back(std::move(value));}
         else{
             SetValue(value);}
     }
@@ -33,21 +56,55 @@ class TypedArgument : public Argument {
     void SetMultiValue(int min_values = INT_MIN) override {
         is_multi_value_ = true;
         min_multi_values_ = min_values;
+        if (!multi_values_) {
+            multi_values_ = &GetExtra().own_multi_values;
+        }
     }
 
     void SetPositional(bool value) override {
         is_positional_ = value;
     }
 
+    void SetLazy(bool value) override {
+        is_lazy_ = value;
+    }
+
     void StoreValues(std::vector<T>& values) {
         multi_values_ = &values;
     }
 
+    void StoreValues(ArgumentParser::StringPool& values)
+        requires std::is_same_v<T, std::string>
+    {
+        GetExtra().string_pool = &values;
+    }
+
     void StoreValue(T& value) {
         external_value_ = &value;
     }
 
-    void SetDefault(T& value) {
+    // Ограничения на значения, нарушения возвращаются через CollectViolations
+    void SetMin(const T& value)
+        requires std::totally_ordered<T>
+    {
+        GetExtra().min_value = value;
+    }
+
+    void SetMax(const T& value)
+        requires std::totally_ordered<T>
+    {
+        GetExtra().max_value = value;
+    }
+
+    void SetNonEmpty(bool value) override {
+        non_empty_ = value;
+    }
+
+    void AddCheck(std::function<bool(const T&)> predicate, std::string message) {
+        GetExtra().checks.emplace_back(std::move(predicate), std::move(message));
+    }
+
+    virtual void SetDefault(const T& value) {
         has_default_value_ = true;
         is_initialized_ = true;
         default_value_ = value;
@@ -62,15 +119,13 @@ class TypedArgument : public Argument {
 
     bool IsPositional() const override { return is_positional_; }
     bool IsMultiValue() const override { return is_multi_value_; }
+    bool IsLazy() const override { return is_lazy_; }
     bool IsInitialized() const override { return is_initialized_; }
     bool HasDefaultValue() const override { return has_default_value_; }
 
     int GetMultiValuesCount() const override {
-        if (multi_values_->size()) {
-            return multi_values_->size();
-        } else {
-            return 0;
-        }
+        size_t stored = Pool() ? Pool()->size() : (multi_values_ ? multi_values_->size() : 0);
+        return static_cast<int>(stored + (extra_ ? extra_->pending.size() : 0));
     }
 
     int GetMinMultiValues() const override {
@@ -82,17 +137,32 @@ class TypedArgument : public Argument {
             throw std::runtime_error("Default value is not set.");
         }
 
-        if constexpr (std::is_same<T, int>::value) {
-            return std::to_string(default_value_);
-        } else if constexpr (std::is_same<T, bool>::value) {
-            return default_value_ ? "true" : "false";
-        } else if constexpr (std::is_same<T, std::string>::value) {
-            return default_value_;
-        }
-        throw std::runtime_error("Unsupported type for argument default value.");
+        return Traits::ToString(default_value_);
     }
 
-    T GetValue(int index = 0) const {
+    const T& GetDefault() const { return default_value_; }
+
+    // Ошибка ленивого преобразования или нарушение ограничения сообщается
+    // при каждом обращении до следующего разбора
+    T GetValue(int index = 0) {
+        Materialize();
+        if (extra_) {
+            if (!extra_->lazy_error.empty()) {
+                throw std::invalid_argument(extra_->lazy_error);
+            }
+            if (!extra_->lazy_violations.empty()) {
+                throw std::invalid_argument("Invalid value for argument " + std::string(long_name_) + ": " +
+                                            extra_->lazy_violations.front());
+            }
+        }
+        if constexpr (std::is_same_v<T, std::string>) {
+            if (is_multi_value_ && Pool()) {
+                if (index < 0 || index >= static_cast<int>(Pool()->size())) {
+                    throw std::out_of_range("Index out of range for multi-value argument.");
+                }
+                return std::string((*Pool())[index]);
+            }
+        }
         if (is_multi_value_ && multi_values_ && !multi_values_->empty()) {
             if (index >= 0 && index < static_cast<int>(multi_values_->size())) {
                 return (*multi_values_)[index];
@@ -104,46 +174,271 @@ class TypedArgument : public Argument {
         return value_;
     }
 
-    std::string GetLongName() const override { return long_name_; }
+    std::string GetLongName() const override { return std::string(long_name_); }
     std::string GetShortName() const override { return std::string(1, short_name_); }
-    std::string GetDescription() const override { return description_; }
+    std::string GetDescription() const override { return std::string(description_); }
 
     ArgType GetType() const override {
         return type_;
     }
 
-    void ParseValue(const std::string& value) override {
-        if constexpr (std::is_same<T, int>::value) {
-            AddValue(std::stoi(value));
-        } else if constexpr (std::is_same<T, bool>::value) {
-            AddValue(bool(value == "true" || value == "1"));
-        } else if constexpr (std::is_same<T, std::string>::value) {
-            AddValue(value);
-        } else {
-            throw std::runtime_error("Unsupported type for argument");
+    // Ленивый аргумент без внешнего хранилища запоминает токен и
+    // преобразует его при первом обращении к значению
+    void ParseValue(std::string_view value) override {
+        if (is_lazy_ && !external_value_ && !Pool() &&
+            (!multi_values_ || multi_values_ == &GetExtra().own_multi_values)) {
+            std::vector<std::string_view>& pending = GetExtra().pending;
+            is_initialized_ = true;
+            if (!is_multi_value_) {
+                pending.clear();
+            }
+            pending.push_back(value);
+            return;
         }
+        ConvertValue(value);
+    }
 
-        if (external_value_) {
-            *external_value_ = value_;
+    void Materialize() override {
+        if (!extra_ || extra_->pending.empty()) {
+            return;
+        }
+
+        size_t reported = extra_->violations.size();
+        try {
+            for (std::string_view token : extra_->pending) {
+                ConvertValue(token);
+            }
+        } catch (const std::exception& error) {
+            extra_->pending.clear();
+            extra_->lazy_error = error.what();
+            throw;
+        }
+        extra_->pending.clear();
+
+        // Нарушения ленивых значений остаются в силе до следующего разбора
+        CheckNewValuesRange();
+        std::vector<std::string>& violations = extra_->violations;
+        extra_->lazy_violations.insert(extra_->lazy_violations.end(), std::make_move_iterator(violations.begin() + reported),
+                                       std::make_move_iterator(violations.end()));
+        violations.resize(reported);
+    }
+
+    void DiscardPending() override {
+        if (extra_) {
+            extra_->pending.clear();
+        }
+    }
+
+    void CollectViolations(std::vector<std::string>& violations) override {
+        if (!extra_) {
+            return;
+        }
+
+        CheckNewValuesRange();
+        for (auto& violation : extra_->violations) {
+            violations.push_back(std::move(violation));
+        }
+        extra_->violations.clear();
+
+        if (!extra_->lazy_error.empty()) {
+            violations.push_back(extra_->lazy_error);
+        }
+        violations.insert(violations.end(), extra_->lazy_violations.begin(), extra_->lazy_violations.end());
+    }
+
+    // Новый разбор: прошлые нарушения уже сообщены или больше не актуальны
+    void ClearViolations() override {
+        if (!extra_) {
+            return;
         }
+        extra_->violations.clear();
+        extra_->lazy_violations.clear();
+        extra_->lazy_error.clear();
+        extra_->range_checked = multi_values_ ? multi_values_->size() : 0;
+    }
+
+    void ClearValues() override {
+        if (extra_) {
+            extra_->pending.clear();
+            extra_->range_checked = 0;
+        }
+        if (Pool()) {
+            Pool()->clear();
+        }
+        if (multi_values_) {
+            multi_values_->clear();
+        }
+    }
+
+   protected:
+    // Проверка ограничений и сохранение преобразованного значения
+    void AcceptValue(T value) {
+        CheckValue(value);
+        AddValue(std::move(value));
+    }
+
+    void CheckValue(const T& value) {
+        if (extra_ || non_empty_) {
+            if constexpr (std::totally_ordered<T>) {
+                if (!is_multi_value_) {
+                    CheckRange(value);
+                }
+            }
+            if constexpr (requires { value.empty(); }) {
+                if (non_empty_ && value.empty()) {
+                    GetExtra().violations.push_back("value must not be empty");
+                }
+            }
+            for (const auto& [predicate, message] : GetExtra().checks) {
+                if (!predicate(value)) {
+                    extra_->violations.push_back("value '" + Traits::ToString(value) + "' " + message);
+                }
+            }
+        }
+    }
+
+    T ParseToken(std::string_view value) const {
+        T parsed{};
+        if (!Traits::Parse(value, parsed)) {
+            throw std::invalid_argument("Invalid " + std::string(Traits::kName) + " value '" + std::string(value) +
+                                        "' for argument " + std::string(long_name_));
+        }
+        return parsed;
+    }
+
+    virtual void ConvertValue(std::string_view value) {
+        // Строки дописываются в пул без создания std::string
+        if constexpr (std::is_same_v<T, std::string>) {
+            if (is_multi_value_ && Pool()) {
+                // Те же проверки, что в AcceptValue, но над string_view;
+                // std::string создается только для пользовательских проверок
+                std::vector<std::string>& violations = extra_->violations;
+                if (non_empty_ && value.empty()) {
+                    violations.push_back("value must not be empty");
+                }
+                if (extra_->min_value && value < std::string_view(*extra_->min_value)) {
+                    violations.push_back("value " + std::string(value) + " is less than minimum " + *extra_->min_value);
+                } else if (extra_->max_value && std::string_view(*extra_->max_value) < value) {
+                    violations.push_back("value " + std::string(value) + " is greater than maximum " + *extra_->max_value);
+                }
+                if (!extra_->checks.empty()) {
+                    std::string copy(value);
+                    for (const auto& [predicate, message] : extra_->checks) {
+                        if (!predicate(copy)) {
+                            violations.push_back("value '" + copy + "' " + message);
+                        }
+                    }
+                }
+                is_initialized_ = true;
+                Pool()->Append(value);
+                return;
+            }
+        }
+        AcceptValue(ParseToken(value));
     }
 
    private:
-    char short_name_{};
-    std::string long_name_{};
-    std::string description_{};
+    // Редко используемое состояние (ограничения, ленивые токены, собственный
+    // список значений) создается по требованию, чтобы обычный аргумент был компактным
+    struct Extra {
+        std::vector<T> own_multi_values;
+        std::vector<std::string_view> pending;
+        ArgumentParser::StringPool* string_pool = nullptr;
 
-    ArgType type_;
+        std::optional<T> min_value;
+        std::optional<T> max_value;
+        std::vector<std::pair<std::function<bool(const T&)>, std::string>> checks;
+        std::vector<std::string> violations;
+        // Результат ленивого преобразования в текущем разборе
+        std::vector<std::string> lazy_violations;
+        std::string lazy_error;
+        size_t range_checked = 0;
+    };
+
+    Extra& GetExtra() {
+        if (!extra_) {
+            extra_ = std::make_unique<Extra>();
+        }
+        return *extra_;
+    }
+
+    ArgumentParser::StringPool* Pool() const {
+        return extra_ ? extra_->string_pool : nullptr;
+    }
+
+    // Диапазон значений MultiValue проверяется разом для всех новых значений
+    void CheckNewValuesRange() {
+        if constexpr (std::totally_ordered<T> && !std::is_same_v<T, bool>) {
+            if (is_multi_value_ && multi_values_ && (extra_->min_value || extra_->max_value)) {
+                if (extra_->range_checked > multi_values_->size()) {
+                    extra_->range_checked = 0;
+                }
+                const T* values = multi_values_->data() + extra_->range_checked;
+                size_t count = multi_values_->size() - extra_->range_checked;
+                if (CountOutOfRange(values, count) != 0) {
+                    for (size_t i = 0; i < count; ++i) {
+                        CheckRange(values[i]);
+                    }
+                }
+                extra_->range_checked = multi_values_->size();
+            }
+        }
+    }
+
+    void CheckRange(const T& value)
+        requires std::totally_ordered<T>
+    {
+        if (!extra_) {
+            return;
+        }
+        if (extra_->min_value && value < *extra_->min_value) {
+            extra_->violations.push_back("value " + Traits::ToString(value) + " is less than minimum " +
+                                         Traits::ToString(*extra_->min_value));
+        } else if (extra_->max_value && *extra_->max_value < value) {
+            extra_->violations.push_back("value " + Traits::ToString(value) + " is greater than maximum " +
+                                         Traits::ToString(*extra_->max_value));
+        }
+    }
+
+    // Число значений вне диапазона; для чисел цикл без ветвлений векторизуется
+    size_t CountOutOfRange(const T* values, size_t count) const
+        requires std::totally_ordered<T>
+    {
+        const std::optional<T>& min_value = extra_->min_value;
+        const std::optional<T>& max_value = extra_->max_value;
+        size_t bad = 0;
+        if constexpr (std::is_arithmetic_v<T>) {
+            const T min = min_value.value_or(std::numeric_limits<T>::lowest());
+            const T max = max_value.value_or(std::numeric_limits<T>::max());
+            for (size_t i = 0; i < count; ++i) {
+                bad += static_cast<size_t>((values[i] < min) | (values[i] > max));
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                bad += (min_value && values[i] < *min_value) || (max_value && *max_value < values[i]);
+            }
+        }
+        return bad;
+    }
+
+    std::string_view long_name_{};
+    std::string_view description_{};
 
     T value_{};
+    T default_value_{};
     T* external_value_ = nullptr;
     std::vector<T>* multi_values_ = nullptr;
+    std::unique_ptr<Extra> extra_;
 
-    T default_value_{};
-
-    bool is_multi_value_ = false;
-    bool is_positional_ = false;
-    bool is_initialized_ = false;
-    bool has_default_value_ = false;
+    uint32_t index_ = 0;
     int min_multi_values_ = INT_MIN;
+    char short_name_{};
+    ArgType type_;
+
+    bool is_multi_value_ : 1 = false;
+    bool is_positional_ : 1 = false;
+    bool is_lazy_ : 1 = false;
+    bool is_initialized_ : 1 = false;
+    bool has_default_value_ : 1 = false;
+    bool non_empty_ : 1 = false;
 };
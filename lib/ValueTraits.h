@@ -0,0 +1,388 @@
+#pragma once
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "Argument.h"
+
+namespace ArgumentParser {
+
+// Длительность: 250ms, 1h30m, 0
+using Duration = std::chrono::nanoseconds;
+
+// Размер в байтах: 512, 64K, 4GiB, 1.5MB
+struct ByteSize {
+    uint64_t bytes = 0;
+
+    bool operator==(const ByteSize&) const = default;
+};
+
+// Адрес вида host:port, [::1]:port или :port
+struct HostPort {
+    std::string host;
+    uint16_t port = 0;
+
+    bool operator==(const HostPort&) const = default;
+};
+
+/*
+    Конвертер строкового значения аргумента в тип T.
+    Специализация должна содержать:
+        static constexpr std::string_view kName;                  - имя типа для сообщений
+        static bool Parse(std::string_view text, T& value);       - разбор, false при ошибке
+        static std::string ToString(const T& value);              - вывод значения по умолчанию
+    Для поддержки нового типа достаточно объявить специализацию
+    ArgumentParser::ValueTraits<MyType> до вызова AddArgument<MyType>
+*/
+template <typename T>
+struct ValueTraits;
+
+namespace detail {
+
+template <typename T>
+bool ParseNumber(std::string_view text, T& value) {
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+    if (first != last && *first == '+') {
+        ++first;
+        // После '+' знак не допускается: "+-5"
+        if (first != last && *first == '-') {
+            return false;
+        }
+    }
+    if (first == last) {
+        return false;
+    }
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    return ec == std::errc() && ptr == last;
+}
+
+// Разбор числа в начале строки, text сдвигается на первый символ после числа
+inline bool ConsumeNumber(std::string_view& text, double& value) {
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    // from_chars принимает "nan" и "inf", для длительностей и размеров они недопустимы
+    if (ec != std::errc() || ptr == first || !std::isfinite(value)) {
+        return false;
+    }
+    text.remove_prefix(ptr - first);
+    return true;
+}
+
+inline bool EqualsIgnoreCase(std::string_view lhs, std::string_view rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        char a = lhs[i] >= 'A' && lhs[i] <= 'Z' ? lhs[i] - 'A' + 'a' : lhs[i];
+        if (a != rhs[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace detail
+
+template <typename T>
+    requires(std::is_integral_v<T> && !std::is_same_v<T, bool>)
+struct ValueTraits<T> {
+    static constexpr std::string_view kName = "int";
+
+    static bool Parse(std::string_view text, T& value) {
+        return detail::ParseNumber(text, value);
+    }
+
+    static std::string ToString(const T& value) {
+        return std::to_string(value);
+    }
+};
+
+template <typename T>
+    requires std::is_floating_point_v<T>
+struct ValueTraits<T> {
+    static constexpr std::string_view kName = "float";
+
+    static bool Parse(std::string_view text, T& value) {
+        return detail::ParseNumber(text, value);
+    }
+
+    static std::string ToString(const T& value) {
+        char buffer[64];
+        auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        return std::string(buffer, ptr);
+    }
+};
+
+// Перечисления по умолчанию разбираются как числа базового типа
+template <typename T>
+    requires std::is_enum_v<T>
+struct ValueTraits<T> {
+    using Underlying = std::underlying_type_t<T>;
+
+    static constexpr std::string_view kName = "enum";
+
+    static bool Parse(std::string_view text, T& value) {
+        Underlying raw{};
+        if (!detail::ParseNumber(text, raw)) {
+            return false;
+        }
+        value = static_cast<T>(raw);
+        return true;
+    }
+
+    static std::string ToString(const T& value) {
+        return std::to_string(static_cast<Underlying>(value));
+    }
+};
+
+template <>
+struct ValueTraits<bool> {
+    static constexpr std::string_view kName = "bool";
+
+    static bool Parse(std::string_view text, bool& value) {
+        if (text == "1" || detail::EqualsIgnoreCase(text, "true") || detail::EqualsIgnoreCase(text, "yes") ||
+            detail::EqualsIgnoreCase(text, "on")) {
+            value = true;
+            return true;
+        }
+        if (text == "0" || detail::EqualsIgnoreCase(text, "false") || detail::EqualsIgnoreCase(text, "no") ||
+            detail::EqualsIgnoreCase(text, "off")) {
+            value = false;
+            return true;
+        }
+        return false;
+    }
+
+    static std::string ToString(const bool& value) {
+        return value ? "true" : "false";
+    }
+};
+
+template <>
+struct ValueTraits<std::string> {
+    static constexpr std::string_view kName = "string";
+
+    static bool Parse(std::string_view text, std::string& value) {
+        value.assign(text);
+        return true;
+    }
+
+    static std::string ToString(const std::string& value) {
+        return value;
+    }
+};
+
+template <>
+struct ValueTraits<std::filesystem::path> {
+    static constexpr std::string_view kName = "path";
+
+    static bool Parse(std::string_view text, std::filesystem::path& value) {
+        if (text.empty()) {
+            return false;
+        }
+        value = std::filesystem::path(text);
+        return true;
+    }
+
+    static std::string ToString(const std::filesystem::path& value) {
+        return value.string();
+    }
+};
+
+template <>
+struct ValueTraits<Duration> {
+    static constexpr std::string_view kName = "duration";
+
+    // Последовательность пар число+единица: ns, us, ms, s, m, min, h
+    static bool Parse(std::string_view text, Duration& value) {
+        if (text == "0") {
+            value = Duration::zero();
+            return true;
+        }
+        if (text.empty()) {
+            return false;
+        }
+
+        double total = 0;
+        while (!text.empty()) {
+            double amount = 0;
+            if (!detail::ConsumeNumber(text, amount) || amount < 0) {
+                return false;
+            }
+            size_t unit_size = 0;
+            while (unit_size < text.size() && text[unit_size] >= 'a' && text[unit_size] <= 'z') {
+                ++unit_size;
+            }
+            double scale = UnitScale(text.substr(0, unit_size));
+            if (scale == 0) {
+                return false;
+            }
+            total += amount * scale;
+            text.remove_prefix(unit_size);
+        }
+
+        if (total > static_cast<double>(Duration::max().count())) {
+            return false;
+        }
+        value = Duration(static_cast<Duration::rep>(std::llround(total)));
+        return true;
+    }
+
+    static std::string ToString(const Duration& value) {
+        static constexpr std::pair<int64_t, std::string_view> kUnits[] = {
+            {3600'000'000'000, "h"}, {60'000'000'000, "m"}, {1'000'000'000, "s"},
+            {1'000'000, "ms"},       {1'000, "us"},         {1, "ns"}};
+
+        int64_t count = value.count();
+        if (count == 0) {
+            return "0";
+        }
+        for (const auto& [scale, unit] : kUnits) {
+            if (count % scale == 0) {
+                return std::to_string(count / scale) + std::string(unit);
+            }
+        }
+        return std::to_string(count) + "ns";
+    }
+
+   private:
+    static double UnitScale(std::string_view unit) {
+        if (unit == "ns") return 1;
+        if (unit == "us") return 1e3;
+        if (unit == "ms") return 1e6;
+        if (unit == "s") return 1e9;
+        if (unit == "m" || unit == "min") return 60e9;
+        if (unit == "h") return 3600e9;
+        return 0;
+    }
+};
+
+template <>
+struct ValueTraits<ByteSize> {
+    static constexpr std::string_view kName = "size";
+
+    // Суффиксы K/M/G/T и KiB/MiB/... - степени 1024, KB/MB/... - степени 1000
+    static bool Parse(std::string_view text, ByteSize& value) {
+        double amount = 0;
+        if (!detail::ConsumeNumber(text, amount) || amount < 0) {
+            return false;
+        }
+
+        double scale = UnitScale(text);
+        if (scale == 0) {
+            return false;
+        }
+        double bytes = amount * scale;
+        if (bytes >= 18446744073709551616.0) {
+            return false;
+        }
+        value.bytes = static_cast<uint64_t>(bytes);
+        return true;
+    }
+
+    static std::string ToString(const ByteSize& value) {
+        static constexpr std::string_view kUnits[] = {"KiB", "MiB", "GiB", "TiB", "PiB", "EiB"};
+
+        uint64_t bytes = value.bytes;
+        int unit = -1;
+        while (bytes != 0 && bytes % 1024 == 0 && unit + 1 < static_cast<int>(std::size(kUnits))) {
+            bytes /= 1024;
+            ++unit;
+        }
+        return std::to_string(bytes) + (unit < 0 ? "B" : std::string(kUnits[unit]));
+    }
+
+   private:
+    static double UnitScale(std::string_view unit) {
+        if (unit.empty() || unit == "B") {
+            return 1;
+        }
+
+        static constexpr std::string_view kPrefixes = "KMGTPE";
+        size_t power = kPrefixes.find(unit[0] >= 'a' && unit[0] <= 'z' ? unit[0] - 'a' + 'A' : unit[0]);
+        if (power == std::string_view::npos) {
+            return 0;
+        }
+        unit.remove_prefix(1);
+
+        double base = 0;
+        if (unit.empty() || unit == "iB" || unit == "i") {
+            base = 1024;
+        } else if (unit == "B") {
+            base = 1000;
+        } else {
+            return 0;
+        }
+        double scale = 1;
+        for (size_t i = 0; i <= power; ++i) {
+            scale *= base;
+        }
+        return scale;
+    }
+};
+
+template <>
+struct ValueTraits<HostPort> {
+    static constexpr std::string_view kName = "host:port";
+
+    static bool Parse(std::string_view text, HostPort& value) {
+        std::string_view host;
+        std::string_view port;
+        if (!text.empty() && text.front() == '[') {
+            size_t close = text.find(']');
+            if (close == std::string_view::npos || close + 1 >= text.size() || text[close + 1] != ':') {
+                return false;
+            }
+            host = text.substr(1, close - 1);
+            port = text.substr(close + 2);
+        } else {
+            size_t colon = text.rfind(':');
+            if (colon == std::string_view::npos || text.find(':') != colon) {
+                return false;
+            }
+            host = text.substr(0, colon);
+            port = text.substr(colon + 1);
+        }
+
+        uint16_t port_value = 0;
+        if (port.empty() || port.front() == '+' || !detail::ParseNumber(port, port_value)) {
+            return false;
+        }
+        value.host.assign(host);
+        value.port = port_value;
+        return true;
+    }
+
+    static std::string ToString(const HostPort& value) {
+        std::string port = ":" + std::to_string(value.port);
+        if (value.host.find(':') != std::string::npos) {
+            return "[" + value.host + "]" + port;
+        }
+        return value.host + port;
+    }
+};
+
+// Тип аргумента для встроенных типов, остальные - CUSTOM
+template <typename T>
+constexpr ArgType ArgTypeOf() {
+    if constexpr (std::is_same_v<T, int>) {
+        return ArgType::INT;
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return ArgType::BOOL;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return ArgType::STRING;
+    } else {
+        return ArgType::CUSTOM;
+    }
+}
+
+}  // namespace ArgumentParser
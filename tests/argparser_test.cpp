@@ -1,3 +1,4 @@
+#include <cstdlib>
 #include <sstream>
 #include <fstream>
 
@@ -219,3 +220,505 @@ TEST(ArgParserTestSuite, HelpStringTest) {
     //     "-h, --help Display this help and exit\n"
     // );
 }
+
+
+TEST(ArgParserTestSuite, ExtendedTypesTest) {
+    ArgParser parser("My Parser");
+    parser.AddArgument<int64_t>("offset");
+    parser.AddArgument<double>("ratio");
+    parser.AddArgument<Duration>('t', "timeout").Default(Duration(std::chrono::seconds(5)));
+    parser.AddArgument<ByteSize>("cache");
+    parser.AddArgument<HostPort>("listen");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --offset=-9000000000 --ratio=0.25 -t 1m30s --cache=4GiB --listen=[::1]:8080")));
+    ASSERT_EQ(parser.GetValue<int64_t>("offset"), -9000000000LL);
+    ASSERT_DOUBLE_EQ(parser.GetValue<double>("ratio"), 0.25);
+    ASSERT_EQ(parser.GetValue<Duration>('t'), std::chrono::seconds(90));
+    ASSERT_EQ(parser.GetValue<ByteSize>("cache").bytes, 4ULL << 30);
+    ASSERT_EQ(parser.GetValue<HostPort>("listen"), (HostPort{"::1", 8080}));
+    ASSERT_EQ(parser.GetArgument<Duration>("timeout").GetDefaultValue(), "5s");
+}
+
+
+struct Point {
+    int x = 0;
+    int y = 0;
+};
+
+template <>
+struct ArgumentParser::ValueTraits<Point> {
+    static constexpr std::string_view kName = "point";
+
+    static bool Parse(std::string_view text, Point& value) {
+        size_t comma = text.find(',');
+        return comma != std::string_view::npos &&
+               ValueTraits<int>::Parse(text.substr(0, comma), value.x) &&
+               ValueTraits<int>::Parse(text.substr(comma + 1), value.y);
+    }
+
+    static std::string ToString(const Point& value) {
+        return std::to_string(value.x) + "," + std::to_string(value.y);
+    }
+};
+
+TEST(ArgParserTestSuite, CustomTypeTest) {
+    ArgParser parser("My Parser");
+    std::vector<Point> points;
+    parser.AddArgument<Point>('p', "point").MultiValue(2).StoreValues(points);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -p 1,2 --point=3,-4")));
+    ASSERT_EQ(points.size(), 2);
+    ASSERT_EQ(points[1].y, -4);
+}
+
+
+TEST(ArgParserTestSuite, InvalidValueTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("number");
+    parser.AddArgument<Duration>("timeout");
+
+    ASSERT_THROW(parser.Parse(SplitString("app --number=12abc")), std::invalid_argument);
+    ASSERT_THROW(parser.Parse(SplitString("app --timeout=10parsecs")), std::invalid_argument);
+
+    Duration duration;
+    ByteSize size;
+    ASSERT_FALSE(ValueTraits<Duration>::Parse("nanms", duration));
+    ASSERT_FALSE(ValueTraits<Duration>::Parse("infs", duration));
+    ASSERT_FALSE(ValueTraits<ByteSize>::Parse("nan", size));
+    ASSERT_FALSE(ValueTraits<ByteSize>::Parse("infK", size));
+
+    int number;
+    double real;
+    ASSERT_FALSE(ValueTraits<int>::Parse("+-5", number));
+    ASSERT_FALSE(ValueTraits<double>::Parse("+-1.5", real));
+    ASSERT_TRUE(ValueTraits<int>::Parse("+5", number));
+    ASSERT_EQ(number, 5);
+    ASSERT_THROW(parser.Parse(SplitString("app --number=+-5")), std::invalid_argument);
+}
+
+
+enum class Mode { Fast, Safe, Debug };
+
+TEST(ArgParserTestSuite, ChoiceTest) {
+    ArgParser parser("My Parser");
+    Mode mode = Mode::Safe;
+    parser.AddChoiceArgument<Mode>('m', "mode", {{"fast", Mode::Fast}, {"safe", Mode::Safe}, {"debug", Mode::Debug}})
+        .Default(Mode::Safe)
+        .StoreValue(mode);
+    parser.AddChoiceArgument<int>("level", {{"error", 0}, {"warn", 1}, {"info", 2}}).MultiValue().Default(1);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -m debug --level=warn --level=info")));
+    ASSERT_EQ(mode, Mode::Debug);
+    ASSERT_EQ(parser.GetArgument<int>("level").GetValue(1), 2);
+    ASSERT_THROW(parser.Parse(SplitString("app --mode=slow")), std::invalid_argument);
+    ASSERT_NE(parser.HelpDescription().find("[choices: fast|safe|debug] [default = safe]"), std::string::npos);
+    parser.AddChoiceArgument<int>("lvl", {{"a", 1}, {"b", 2}});
+    ASSERT_THROW(parser.Default(7), std::invalid_argument);
+}
+
+
+TEST(ArgParserTestSuite, LazyValueTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument('n', "number").Lazy();
+    parser.AddIntArgument("values").MultiValue(2).Lazy();
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 7 --values=1 --values=2 --values=3")));
+    ASSERT_EQ(parser.GetIntValue("number"), 7);
+    ASSERT_EQ(parser.GetArgument<int>("values").GetValue(2), 3);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --number=oops")));
+    ASSERT_THROW(parser.ValidateAll(), std::invalid_argument);
+
+    // Непрочитанный неверный токен прошлого разбора не мешает следующему
+    ASSERT_TRUE(parser.Parse(SplitString("app --number=oops --values=4 --values=5")));
+    ASSERT_TRUE(parser.Parse(SplitString("app --number=5 --values=4 --values=5")));
+    ASSERT_EQ(parser.GetIntValue("number"), 5);
+}
+
+
+TEST(ArgParserTestSuite, StringPoolTest) {
+    ArgParser parser("My Parser");
+    StringPool files(/*intern=*/true);
+    parser.AddStringArgument("file").MultiValue(1).Positional().StoreValues(files);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app a.txt b.txt a.txt c.txt")));
+    ASSERT_EQ(files.size(), 4);
+    ASSERT_EQ(files.UniqueCount(), 3);
+    ASSERT_EQ(files[2], "a.txt");
+    ASSERT_EQ(parser.GetArgument<std::string>("file").GetValue(3), "c.txt");
+    ASSERT_EQ(std::vector<std::string_view>(files.begin(), files.end()),
+              (std::vector<std::string_view>{"a.txt", "b.txt", "a.txt", "c.txt"}));
+    ASSERT_GT(files.MemoryUsage(), 0);
+}
+
+
+TEST(ArgParserTestSuite, FeedTest) {
+    ArgParser parser("My Parser");
+    std::vector<int> values;
+    parser.AddFlag('f', "flag", "Flag");
+    parser.AddIntArgument('n', "number", "Some Number");
+    parser.AddIntArgument("Param1").MultiValue(1).Positional().StoreValues(values);
+
+    for (const auto& token : SplitString("-fn -3 1 2")) {
+        parser.Feed(token);
+    }
+    ASSERT_TRUE(parser.Finish());
+    ASSERT_TRUE(parser.GetFlag("flag"));
+    ASSERT_EQ(parser.GetIntValue("number"), -3);
+    ASSERT_EQ(values.size(), 2);
+
+    parser.Feed("-n");
+    ASSERT_THROW(parser.Feed("x"), std::invalid_argument);
+    parser.Feed("--number=5");
+    ASSERT_TRUE(parser.Finish());
+    ASSERT_EQ(parser.GetIntValue('n'), 5);
+}
+
+
+TEST(ArgParserTestSuite, FeedLazyTokenTest) {
+    ArgParser parser("My Parser");
+    parser.AddStringArgument("s").Lazy();
+    parser.AddIntArgument('n', "number").Lazy();
+
+    std::string buffer = "--s=a value longer than the small string buffer";
+    parser.Feed(buffer);
+    {
+        std::string temporary = "-n";
+        parser.Feed(temporary);
+        temporary = "42";
+        parser.Feed(temporary);
+    }
+    buffer.assign(buffer.size(), 'x');
+    ASSERT_TRUE(parser.Finish());
+    ASSERT_EQ(parser.GetStringValue("s"), "a value longer than the small string buffer");
+    ASSERT_EQ(parser.GetIntValue('n'), 42);
+}
+
+
+TEST(ArgParserTestSuite, UnknownArgumentsTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag('v', "verbose");
+    parser.AddIntArgument('j', "jobs").Default(1);
+    parser.AllowUnknownArguments();
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -v --color=auto -j 4 -vx input.txt -- --jobs=8")));
+    ASSERT_EQ(parser.GetIntValue("jobs"), 4);
+    ASSERT_EQ(parser.GetRemainder(),
+              (std::vector<std::string_view>{"--color=auto", "-vx", "input.txt", "--jobs=8"}));
+
+    // Остаток из Feed не зависит от буферов вызывающего
+    {
+        std::string token = "--unknown=a value longer than the small string buffer";
+        parser.Feed(token);
+        token = "-vz";
+        parser.Feed(token);
+        token = "--";
+        parser.Feed(token);
+        token = "tail";
+        parser.Feed(token);
+    }
+    ASSERT_TRUE(parser.Finish());
+    ASSERT_EQ(parser.GetRemainder(),
+              (std::vector<std::string_view>{"--unknown=a value longer than the small string buffer", "-vz", "tail"}));
+
+    ArgParser strict("Strict Parser");
+    ASSERT_THROW(strict.Parse(SplitString("app --color=auto")), std::runtime_error);
+}
+
+
+TEST(ArgParserTestSuite, ConstraintsTest) {
+    ArgParser parser("My Parser");
+    std::vector<int> ports;
+    parser.AddIntArgument('p', "port").MultiValue(1).StoreValues(ports).Min(1).Max(65535);
+    parser.AddIntArgument("threads").Default(1).Check<int>([](const int& value) { return value % 2 == 0; }, "must be even");
+    parser.AddStringArgument("name").NonEmpty();
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -p 80 -p 443 --threads=4 --name=x")));
+
+    ParseResult result = parser.Parse(SplitString("app -p 8080 -p 70000 --threads=3 --name="));
+    ASSERT_FALSE(result);
+    ASSERT_EQ(result.GetErrors().size(), 3);
+    ASSERT_NE(result.ErrorMessage().find("--port: value 70000 is greater than maximum 65535"), std::string::npos);
+    ASSERT_NE(result.ErrorMessage().find("--threads: value '3' must be even"), std::string::npos);
+    ASSERT_NE(result.ErrorMessage().find("--name: value must not be empty"), std::string::npos);
+
+    // Значения в StringPool проверяются так же, как в std::vector
+    ArgParser pooled("Pooled Parser");
+    StringPool files;
+    pooled.AddStringArgument("file").MultiValue().StoreValues(files).Max<std::string>("m").Check<std::string>(
+        [](const std::string& value) { return value.ends_with(".txt"); }, "must end with .txt");
+    ASSERT_TRUE(pooled.Parse(SplitString("app --file=a.txt")));
+    result = pooled.Parse(SplitString("app --file=a.exe --file=z.txt"));
+    ASSERT_FALSE(result);
+    ASSERT_EQ(result.ErrorMessage(), "--file: value 'a.exe' must end with .txt\n--file: value z.txt is greater than maximum m");
+}
+
+
+TEST(ArgParserTestSuite, LazyConstraintsTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("n").Default(1).Lazy().Max(5);
+    parser.AddIntArgument("values").MultiValue().Lazy().Max(5);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --n=9 --values=2 --values=7")));
+    ASSERT_THROW(parser.GetIntValue("n"), std::invalid_argument);
+    ASSERT_THROW(parser.GetIntValue("n"), std::invalid_argument);
+    ASSERT_THROW(parser.GetArgument<int>("values").GetValue(1), std::invalid_argument);
+    ASSERT_THROW(parser.GetArgument<int>("values").GetValue(0), std::invalid_argument);
+    ASSERT_FALSE(parser.ValidateAll());
+    ASSERT_TRUE(parser.Parse(SplitString("app")));
+    ASSERT_TRUE(parser.ValidateAll());
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --n=8")));
+    ParseResult result = parser.ValidateAll();
+    ASSERT_FALSE(result);
+    ASSERT_EQ(result.ErrorMessage(), "--n: value 8 is greater than maximum 5");
+    ASSERT_FALSE(parser.ValidateAll());
+    ASSERT_THROW(parser.GetIntValue("n"), std::invalid_argument);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --n=oops")));
+    ASSERT_THROW(parser.GetIntValue("n"), std::invalid_argument);
+    ASSERT_THROW(parser.GetIntValue("n"), std::invalid_argument);
+    ASSERT_FALSE(parser.ValidateAll());
+    ASSERT_TRUE(parser.Parse(SplitString("app --n=3")));
+    ASSERT_EQ(parser.GetIntValue("n"), 3);
+}
+
+
+TEST(ArgParserTestSuite, ParseErrorsTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("number");
+    parser.AddIntArgument("values").MultiValue(2);
+
+    ParseResult result = parser.Parse(SplitString("app --values=1"));
+    ASSERT_FALSE(result);
+    ASSERT_EQ(result.GetErrors().size(), 2);
+    ASSERT_EQ(result.GetErrors()[0].argument, "--values");
+    ASSERT_EQ(result.GetErrors()[1].argument, "--number");
+}
+
+
+void SetEnv(const char* name, const char* value) {
+#ifdef _WIN32
+    _putenv_s(name, value);
+#else
+    setenv(name, value, 1);
+#endif
+}
+
+TEST(ArgParserTestSuite, EnvTest) {
+    SetEnv("ARGPARSER_TEST_PORT", "8080");
+    SetEnv("ARGPARSER_TEST_LOG_LEVEL", "debug");
+    SetEnv("ARGPARSER_TEST_VERBOSE", "1");
+
+    ArgParser parser("My Parser");
+    parser.EnvPrefix("ARGPARSER_TEST_");
+    parser.AddIntArgument('p', "port").Env();
+    parser.AddStringArgument("log-level").Default("info").Env();
+    parser.AddStringArgument("user").Default("root").Env();
+    parser.AddFlag('v', "verbose").Env("VERBOSE");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app")));
+    ASSERT_EQ(parser.GetIntValue("port"), 8080);
+    ASSERT_EQ(parser.GetStringValue("log-level"), "debug");
+    ASSERT_EQ(parser.GetStringValue("user"), "root");
+    ASSERT_TRUE(parser.GetFlag("verbose"));
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -p 9090")));
+    ASSERT_EQ(parser.GetIntValue("port"), 9090);
+    ASSERT_NE(parser.HelpDescription().find("[env: ARGPARSER_TEST_LOG_LEVEL]"), std::string::npos);
+}
+
+
+TEST(ArgParserTestSuite, GroupRulesTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag('s', "sum");
+    parser.AddFlag("mult");
+    parser.AddStringArgument('o', "output").Default("-");
+    parser.AddStringArgument("format").Default("text");
+    parser.MutuallyExclusive({"sum", "mult"});
+    parser.RequireOneOf({"sum", "mult"});
+    parser.Requires("output", {"format"});
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -s -o out.json --format=json")));
+
+    ParseResult result = parser.Parse(SplitString("app --sum --mult -o out.json"));
+    ASSERT_FALSE(result);
+    ASSERT_EQ(result.ErrorMessage(), "--sum, --mult are mutually exclusive\n--output requires --format");
+
+    result = parser.Parse(SplitString("app"));
+    ASSERT_EQ(result.ErrorMessage(), "one of --sum, --mult is required");
+    ASSERT_THROW(parser.MutuallyExclusive({"sum", "missing"}), std::invalid_argument);
+}
+
+
+TEST(ArgParserTestSuite, SuggestionTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag('v', "verbose");
+    parser.AddStringArgument("color").Default("auto");
+    parser.AddIntArgument("columns").Default(80);
+
+    ASSERT_EQ(parser.SuggestArgument("colr"), "--color");
+    ASSERT_EQ(parser.SuggestArgument("colums"), "--columns");
+    ASSERT_EQ(parser.SuggestArgument("xyz"), "");
+
+    try {
+        parser.Parse(SplitString("app --verbos"));
+        FAIL();
+    } catch (const std::runtime_error& error) {
+        ASSERT_STREQ(error.what(), "Unknown argument: verbos. Did you mean --verbose?");
+    }
+    try {
+        parser.Parse(SplitString("app -V"));
+        FAIL();
+    } catch (const std::runtime_error& error) {
+        ASSERT_STREQ(error.what(), "Unknown argument: -V. Did you mean -v?");
+    }
+    try {
+        parser.Parse(SplitString("app -color=never"));
+        FAIL();
+    } catch (const std::runtime_error& error) {
+        ASSERT_STREQ(error.what(), "Unknown argument: -c. Did you mean --color?");
+    }
+}
+
+
+TEST(ArgParserTestSuite, EditDistanceTest) {
+    std::string long_name(100, 'a');
+    ASSERT_EQ(EditDistance("kitten").Distance("sitting"), 3);
+    ASSERT_EQ(EditDistance("flaw").Distance("lawn"), 2);
+    ASSERT_EQ(EditDistance("").Distance("abc"), 3);
+    ASSERT_EQ(EditDistance(std::string(64, 'x')).Distance(std::string(62, 'x') + "yy"), 2);
+    ASSERT_EQ(EditDistance(long_name).Distance(long_name + "b"), 1);
+}
+
+
+TEST(ArgParserTestSuite, ManyArgumentsTest) {
+    ArgParser parser("My Parser");
+    parser.Reserve(20000);
+    for (int i = 0; i < 20000; ++i) {
+        parser.AddIntArgument("option-" + std::to_string(i), "option").Default(i);
+    }
+    parser.AddIntArgument('r', "required");
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --option-19999=5")));
+    ASSERT_TRUE(parser.Parse(SplitString("app --option-19999=5 -r 1")));
+    ASSERT_EQ(parser.GetIntValue("option-19999"), 5);
+    ASSERT_EQ(parser.GetIntValue("option-42"), 42);
+
+    std::string help = parser.HelpDescription();
+    ASSERT_LT(help.find("--option-0,"), help.find("--option-1,"));
+    ASSERT_NE(help.find("\n--option-0,  option [default = 0]\n"), std::string::npos);
+    ASSERT_NE(help.find("\n-r, --required,  \n"), std::string::npos);
+}
+
+
+TEST(ArgParserTestSuite, PluginTest) {
+    ArgParser parser("My Parser");
+    int factory_calls = 0;
+    parser.AddFlag('v', "verbose");
+    parser.AddPlugin("cache", [&](ArgParser& cache) {
+        ++factory_calls;
+        cache.AddIntArgument("size").Min(1);
+        cache.AddStringArgument("dir").Default("/tmp");
+    }, "Cache settings");
+    parser.AddPlugin("net", [&](ArgParser& net) {
+        ++factory_calls;
+        net.AddIntArgument("port");
+    });
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -v")));
+    ASSERT_EQ(factory_calls, 0);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --plugin.cache.size=64 --plugin.cache.dir /var/cache -v")));
+    ASSERT_EQ(factory_calls, 1);
+    ASSERT_TRUE(parser.IsPluginLoaded("cache"));
+    ASSERT_FALSE(parser.IsPluginLoaded("net"));
+    ASSERT_EQ(parser.GetPlugin("cache").GetIntValue("size"), 64);
+    ASSERT_EQ(parser.GetPlugin("cache").GetStringValue("dir"), "/var/cache");
+    ASSERT_TRUE(parser.GetFlag("verbose"));
+
+    ParseResult result = parser.Parse(SplitString("app --plugin.cache.size=0"));
+    ASSERT_FALSE(result);
+    ASSERT_EQ(result.GetErrors()[0].argument, "--plugin.cache.size");
+
+    try {
+        parser.Parse(SplitString("app --plugin.cache.sise=1"));
+        FAIL();
+    } catch (const std::runtime_error& error) {
+        ASSERT_STREQ(error.what(), "Unknown argument: plugin.cache.sise. Did you mean --plugin.cache.size?");
+    }
+    ASSERT_THROW(parser.Parse(SplitString("app --plugin.db.url=x")), std::runtime_error);
+    ASSERT_EQ(factory_calls, 1);
+    ASSERT_NE(parser.HelpDescription().find("--plugin.cache.*,  Cache settings [Plugin]"), std::string::npos);
+}
+
+
+TEST(ArgParserTestSuite, CountFlagTest) {
+    ArgParser parser("My Parser");
+    parser.AddCountFlag('v', "verbose");
+    parser.AddFlag('q', "quiet");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -vvqv --verbose")));
+    ASSERT_EQ(parser.GetIntValue("verbose"), 4);
+    ASSERT_TRUE(parser.GetFlag("quiet"));
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -v")));
+    ASSERT_EQ(parser.GetIntValue('v'), 1);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --verbose=3 -v")));
+    ASSERT_EQ(parser.GetIntValue("verbose"), 4);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app")));
+    ASSERT_EQ(parser.GetIntValue("verbose"), 0);
+
+    // Ограничение проверяется один раз для итогового счета
+    ArgParser limited("My Parser");
+    limited.AddCountFlag('v', "verbose").Max(2);
+    ParseResult result = limited.Parse(SplitString("app -vvvvv"));
+    ASSERT_FALSE(result);
+    ASSERT_EQ(result.ErrorMessage(), "--verbose: value 5 is greater than maximum 2");
+    result = limited.Parse(SplitString("app --verbose=5 -v"));
+    ASSERT_EQ(result.ErrorMessage(), "--verbose: value 6 is greater than maximum 2");
+    ASSERT_TRUE(limited.Parse(SplitString("app -vv")));
+}
+
+
+TEST(ArgParserTestSuite, PackedFlagsTest) {
+    ArgParser parser("My Parser");
+    bool store = false;
+    for (int i = 0; i < 100; ++i) {
+        parser.AddFlag("feature-" + std::to_string(i));
+    }
+    parser.AddFlag('a', "all");
+    parser.AddFlag('b', "brief").StoreValue(store);
+    parser.AddFlag('c', "color").Default(true);
+    // До первого разбора битовый набор уже содержит значения по умолчанию
+    ASSERT_EQ(parser.GetFlags()[1], uint64_t{1} << (parser.FlagBit("color") - 64));
+    ASSERT_TRUE(parser.GetFlag("color"));
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -ab --feature-3 --feature-70 --color=false")));
+    const std::vector<uint64_t>& flags = parser.GetFlags();
+    ASSERT_EQ(flags.size(), 2);
+    ASSERT_EQ(flags[0], uint64_t{1} << 3);
+    ASSERT_EQ(flags[1], (uint64_t{1} << (70 - 64)) | (uint64_t{1} << (parser.FlagBit("all") - 64)) |
+                            (uint64_t{1} << (parser.FlagBit("brief") - 64)));
+    ASSERT_TRUE(parser.GetFlag("all"));
+    ASSERT_TRUE(store);
+    ASSERT_FALSE(parser.GetFlag("color"));
+
+    ASSERT_TRUE(parser.Parse(SplitString("app")));
+    ASSERT_EQ(parser.GetFlags()[0], 0);
+    ASSERT_EQ(parser.GetFlags()[1], uint64_t{1} << (parser.FlagBit("color") - 64));
+    ASSERT_FALSE(parser.GetFlag("all"));
+    ASSERT_FALSE(store);
+    ASSERT_TRUE(parser.GetFlag("color"));
+    ASSERT_THROW(parser.FlagBit("missing"), std::invalid_argument);
+
+    // Значение доступно сразу после Feed, до Finish
+    parser.Feed("-b");
+    ASSERT_TRUE(store);
+    ASSERT_TRUE(parser.GetFlag('b'));
+    parser.Feed("--feature-3");
+    ASSERT_TRUE(parser.GetFlag("feature-3"));
+    ASSERT_TRUE(parser.Finish());
+}